@@ -0,0 +1,446 @@
+/**
+ * @file blend565.c
+ * RGB565 fill and blend kernels with a scalar reference and vectorized variants
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "blend565.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BLEND565_X86 1
+#include <immintrin.h>
+#else
+#define BLEND565_X86 0
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define OPA_MAX         253     // Same as LV_OPA_MAX
+#define MIX_MASK        0x7E0F81FU  // RGB565 spread out so every channel has room for the product
+
+/* Where LVGL 8.3's masked blending uses the mask alone (opa) or the opacity alone (mask), see mask_opa() */
+#define FILL_OPA_FULL   OPA_MAX         // fill_normal(): opa >= LV_OPA_MAX
+#define FILL_MASK_FULL  255             // fill_normal(): mask == LV_OPA_COVER
+#define MAP_OPA_FULL    (OPA_MAX + 1)   // map_normal(): opa > LV_OPA_MAX
+#define MAP_MASK_FULL   OPA_MAX         // map_normal(): mask >= LV_OPA_MAX
+
+#define SELFTEST_CASES  2000
+#define SELFTEST_MAX_W  67
+#define SELFTEST_MAX_H  9
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef void (*fill_row_fn_t)(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask);
+typedef void (*map_row_fn_t)(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask);
+
+typedef struct {
+    const char * name;
+    fill_row_fn_t fill_row;
+    map_row_fn_t map_row;
+} blend565_kernels_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static inline uint16_t mix_px(uint16_t fg, uint16_t bg, uint8_t mix);
+static inline uint8_t mask_opa(uint8_t mask, uint8_t opa, uint8_t opa_full, uint8_t mask_full);
+static void fill_row_scalar(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask);
+static void map_row_scalar(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask);
+#if BLEND565_X86
+static void fill_row_sse41(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask);
+static void map_row_sse41(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask);
+static void fill_row_avx2(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask);
+static void map_row_avx2(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask);
+#endif
+static const blend565_kernels_t * active_kernels(void);
+static uint32_t selftest_rand(uint32_t * seed);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const blend565_kernels_t kernels[BLEND565_IMPL_COUNT] = {
+    [BLEND565_IMPL_SCALAR] = {"scalar", fill_row_scalar, map_row_scalar},
+#if BLEND565_X86
+    [BLEND565_IMPL_SSE41] = {"sse4.1", fill_row_sse41, map_row_sse41},
+    [BLEND565_IMPL_AVX2] = {"avx2", fill_row_avx2, map_row_avx2},
+#else
+    [BLEND565_IMPL_SSE41] = {"sse4.1", NULL, NULL},
+    [BLEND565_IMPL_AVX2] = {"avx2", NULL, NULL},
+#endif
+};
+
+static const blend565_kernels_t * selected;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* lv_color_mix() of LVGL for 16 bit colors: 5 bit precision on the packed channels */
+static inline uint16_t mix_px(uint16_t fg, uint16_t bg, uint8_t mix)
+{
+    uint32_t m = ((uint32_t)mix + 4) >> 3;
+    uint32_t f = ((uint32_t)fg | ((uint32_t)fg << 16)) & MIX_MASK;
+    uint32_t b = ((uint32_t)bg | ((uint32_t)bg << 16)) & MIX_MASK;
+    uint32_t r = ((((f - b) * m) >> 5) + b) & MIX_MASK;
+    return (uint16_t)((r >> 16) | r);
+}
+
+/**
+ * Opacity of a masked pixel: the mask scaled by `opa` like LVGL does it.
+ * From `opa_full` on the mask is used alone, from `mask_full` on the opacity alone.
+ */
+static inline uint8_t mask_opa(uint8_t mask, uint8_t opa, uint8_t opa_full, uint8_t mask_full)
+{
+    if (opa >= opa_full) return mask;
+    if (mask >= mask_full) return opa;
+    return (uint8_t)(((uint32_t)mask * opa) >> 8);
+}
+
+static void fill_row_scalar(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask)
+{
+    int32_t x;
+    if (mask == NULL) {
+        for (x = 0; x < w; x++) dest[x] = mix_px(color, dest[x], opa);
+    } else {
+        for (x = 0; x < w; x++) dest[x] = mix_px(color, dest[x], mask_opa(mask[x], opa, FILL_OPA_FULL, FILL_MASK_FULL));
+    }
+}
+
+static void map_row_scalar(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask)
+{
+    int32_t x;
+    if (mask == NULL) {
+        for (x = 0; x < w; x++) dest[x] = mix_px(src[x], dest[x], opa);
+    } else {
+        for (x = 0; x < w; x++) dest[x] = mix_px(src[x], dest[x], mask_opa(mask[x], opa, MAP_OPA_FULL, MAP_MASK_FULL));
+    }
+}
+
+#if BLEND565_X86
+
+/* Same arithmetic as mix_px() on 4 pixels held in 32 bit lanes */
+__attribute__((target("sse4.1")))
+static inline __m128i mix4_sse41(__m128i fg, __m128i bg, __m128i mix)
+{
+    const __m128i spread = _mm_set1_epi32(MIX_MASK);
+    __m128i m = _mm_srli_epi32(_mm_add_epi32(mix, _mm_set1_epi32(4)), 3);
+    __m128i f = _mm_and_si128(_mm_or_si128(fg, _mm_slli_epi32(fg, 16)), spread);
+    __m128i b = _mm_and_si128(_mm_or_si128(bg, _mm_slli_epi32(bg, 16)), spread);
+    __m128i r = _mm_mullo_epi32(_mm_sub_epi32(f, b), m);
+    r = _mm_and_si128(_mm_add_epi32(_mm_srli_epi32(r, 5), b), spread);
+    return _mm_and_si128(_mm_or_si128(_mm_srli_epi32(r, 16), r), _mm_set1_epi32(0xFFFF));
+}
+
+/* Opacity of 4 pixels in 32 bit lanes from 4 mask bytes, same rules as mask_opa() */
+__attribute__((target("sse4.1")))
+static inline __m128i mask4_sse41(const uint8_t * mask, uint8_t opa, uint8_t opa_full, uint8_t mask_full)
+{
+    int32_t m4;
+    memcpy(&m4, mask, sizeof(m4));
+    __m128i m = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(m4));
+    if (opa >= opa_full) return m;
+    __m128i opa_v = _mm_set1_epi32(opa);
+    __m128i full = _mm_cmpgt_epi32(m, _mm_set1_epi32(mask_full - 1));
+    return _mm_blendv_epi8(_mm_srli_epi32(_mm_mullo_epi32(m, opa_v), 8), opa_v, full);
+}
+
+/* Blend 8 pixels of `fg` onto `dest` */
+__attribute__((target("sse4.1")))
+static inline void blend8_sse41(uint16_t * dest, __m128i fg_lo, __m128i fg_hi, __m128i mix_lo, __m128i mix_hi)
+{
+    __m128i bg = _mm_loadu_si128((const __m128i *)dest);
+    __m128i bg_lo = _mm_cvtepu16_epi32(bg);
+    __m128i bg_hi = _mm_cvtepu16_epi32(_mm_unpackhi_epi64(bg, bg));
+    __m128i r_lo = mix4_sse41(fg_lo, bg_lo, mix_lo);
+    __m128i r_hi = mix4_sse41(fg_hi, bg_hi, mix_hi);
+    _mm_storeu_si128((__m128i *)dest, _mm_packus_epi32(r_lo, r_hi));
+}
+
+__attribute__((target("sse4.1")))
+static void fill_row_sse41(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask)
+{
+    const __m128i fg = _mm_set1_epi32(color);
+    const __m128i opa_v = _mm_set1_epi32(opa);
+    int32_t x = 0;
+
+    for (; x + 8 <= w; x += 8) {
+        __m128i mix_lo = opa_v;
+        __m128i mix_hi = opa_v;
+        if (mask) {
+            mix_lo = mask4_sse41(&mask[x], opa, FILL_OPA_FULL, FILL_MASK_FULL);
+            mix_hi = mask4_sse41(&mask[x + 4], opa, FILL_OPA_FULL, FILL_MASK_FULL);
+        }
+        blend8_sse41(&dest[x], fg, fg, mix_lo, mix_hi);
+    }
+
+    fill_row_scalar(&dest[x], w - x, color, opa, mask ? &mask[x] : NULL);
+}
+
+__attribute__((target("sse4.1")))
+static void map_row_sse41(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask)
+{
+    const __m128i opa_v = _mm_set1_epi32(opa);
+    int32_t x = 0;
+
+    for (; x + 8 <= w; x += 8) {
+        __m128i fg = _mm_loadu_si128((const __m128i *)&src[x]);
+        __m128i fg_lo = _mm_cvtepu16_epi32(fg);
+        __m128i fg_hi = _mm_cvtepu16_epi32(_mm_unpackhi_epi64(fg, fg));
+        __m128i mix_lo = opa_v;
+        __m128i mix_hi = opa_v;
+        if (mask) {
+            mix_lo = mask4_sse41(&mask[x], opa, MAP_OPA_FULL, MAP_MASK_FULL);
+            mix_hi = mask4_sse41(&mask[x + 4], opa, MAP_OPA_FULL, MAP_MASK_FULL);
+        }
+        blend8_sse41(&dest[x], fg_lo, fg_hi, mix_lo, mix_hi);
+    }
+
+    map_row_scalar(&dest[x], &src[x], w - x, opa, mask ? &mask[x] : NULL);
+}
+
+/* Same arithmetic as mix_px() on 8 pixels held in 32 bit lanes */
+__attribute__((target("avx2")))
+static inline __m256i mix8_avx2(__m256i fg, __m256i bg, __m256i mix)
+{
+    const __m256i spread = _mm256_set1_epi32(MIX_MASK);
+    __m256i m = _mm256_srli_epi32(_mm256_add_epi32(mix, _mm256_set1_epi32(4)), 3);
+    __m256i f = _mm256_and_si256(_mm256_or_si256(fg, _mm256_slli_epi32(fg, 16)), spread);
+    __m256i b = _mm256_and_si256(_mm256_or_si256(bg, _mm256_slli_epi32(bg, 16)), spread);
+    __m256i r = _mm256_mullo_epi32(_mm256_sub_epi32(f, b), m);
+    r = _mm256_and_si256(_mm256_add_epi32(_mm256_srli_epi32(r, 5), b), spread);
+    return _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(r, 16), r), _mm256_set1_epi32(0xFFFF));
+}
+
+/* Opacity of 8 pixels in 32 bit lanes from 8 mask bytes, same rules as mask_opa() */
+__attribute__((target("avx2")))
+static inline __m256i mask8_avx2(const uint8_t * mask, uint8_t opa, uint8_t opa_full, uint8_t mask_full)
+{
+    __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)mask));
+    if (opa >= opa_full) return m;
+    __m256i opa_v = _mm256_set1_epi32(opa);
+    __m256i full = _mm256_cmpgt_epi32(m, _mm256_set1_epi32(mask_full - 1));
+    return _mm256_blendv_epi8(_mm256_srli_epi32(_mm256_mullo_epi32(m, opa_v), 8), opa_v, full);
+}
+
+/* Blend 8 pixels of `fg` onto `dest` */
+__attribute__((target("avx2")))
+static inline void blend8_avx2(uint16_t * dest, __m256i fg, __m256i mix)
+{
+    __m256i bg = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)dest));
+    __m256i r = mix8_avx2(fg, bg, mix);
+    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+    _mm_storeu_si128((__m128i *)dest, packed);
+}
+
+__attribute__((target("avx2")))
+static void fill_row_avx2(uint16_t * dest, int32_t w, uint16_t color, uint8_t opa, const uint8_t * mask)
+{
+    const __m256i fg = _mm256_set1_epi32(color);
+    const __m256i opa_v = _mm256_set1_epi32(opa);
+    int32_t x = 0;
+
+    for (; x + 16 <= w; x += 16) {
+        __m256i mix_lo = opa_v;
+        __m256i mix_hi = opa_v;
+        if (mask) {
+            mix_lo = mask8_avx2(&mask[x], opa, FILL_OPA_FULL, FILL_MASK_FULL);
+            mix_hi = mask8_avx2(&mask[x + 8], opa, FILL_OPA_FULL, FILL_MASK_FULL);
+        }
+        blend8_avx2(&dest[x], fg, mix_lo);
+        blend8_avx2(&dest[x + 8], fg, mix_hi);
+    }
+
+    fill_row_scalar(&dest[x], w - x, color, opa, mask ? &mask[x] : NULL);
+}
+
+__attribute__((target("avx2")))
+static void map_row_avx2(uint16_t * dest, const uint16_t * src, int32_t w, uint8_t opa, const uint8_t * mask)
+{
+    const __m256i opa_v = _mm256_set1_epi32(opa);
+    int32_t x = 0;
+
+    for (; x + 16 <= w; x += 16) {
+        __m256i fg_lo = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&src[x]));
+        __m256i fg_hi = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&src[x + 8]));
+        __m256i mix_lo = opa_v;
+        __m256i mix_hi = opa_v;
+        if (mask) {
+            mix_lo = mask8_avx2(&mask[x], opa, MAP_OPA_FULL, MAP_MASK_FULL);
+            mix_hi = mask8_avx2(&mask[x + 8], opa, MAP_OPA_FULL, MAP_MASK_FULL);
+        }
+        blend8_avx2(&dest[x], fg_lo, mix_lo);
+        blend8_avx2(&dest[x + 8], fg_hi, mix_hi);
+    }
+
+    map_row_scalar(&dest[x], &src[x], w - x, opa, mask ? &mask[x] : NULL);
+}
+
+#endif /*BLEND565_X86*/
+
+static const blend565_kernels_t * active_kernels(void)
+{
+    if (selected == NULL) {
+        blend565_impl_t impl = BLEND565_IMPL_AVX2;
+        while (!blend565_impl_supported(impl)) impl--;
+        selected = &kernels[impl];
+    }
+    return selected;
+}
+
+/* Own generator for the selftest so it leaves the rand() sequence of the application alone */
+static uint32_t selftest_rand(uint32_t * seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return *seed >> 16;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void blend565_fill(uint16_t * dest, int32_t dest_stride, int32_t w, int32_t h, uint16_t color, uint8_t opa,
+                   const uint8_t * mask, int32_t mask_stride)
+{
+    int32_t y;
+
+    // Opaque fill is a plain store, the mixing formula yields `color` there anyway
+    if (mask == NULL && opa >= OPA_MAX) {
+        for (y = 0; y < h; y++) {
+            for (int32_t x = 0; x < w; x++) dest[x] = color;
+            dest += dest_stride;
+        }
+        return;
+    }
+
+    fill_row_fn_t fill_row = active_kernels()->fill_row;
+    for (y = 0; y < h; y++) {
+        fill_row(dest, w, color, opa, mask);
+        dest += dest_stride;
+        if (mask) mask += mask_stride;
+    }
+}
+
+void blend565_map(uint16_t * dest, int32_t dest_stride, const uint16_t * src, int32_t src_stride,
+                  int32_t w, int32_t h, uint8_t opa, const uint8_t * mask, int32_t mask_stride)
+{
+    int32_t y;
+
+    if (mask == NULL && opa >= OPA_MAX) {
+        for (y = 0; y < h; y++) {
+            memcpy(dest, src, w * sizeof(uint16_t));
+            dest += dest_stride;
+            src += src_stride;
+        }
+        return;
+    }
+
+    map_row_fn_t map_row = active_kernels()->map_row;
+    for (y = 0; y < h; y++) {
+        map_row(dest, src, w, opa, mask);
+        dest += dest_stride;
+        src += src_stride;
+        if (mask) mask += mask_stride;
+    }
+}
+
+bool blend565_impl_supported(blend565_impl_t impl)
+{
+    switch (impl) {
+        case BLEND565_IMPL_SCALAR:
+            return true;
+#if BLEND565_X86
+        case BLEND565_IMPL_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case BLEND565_IMPL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool blend565_set_impl(blend565_impl_t impl)
+{
+    if (impl >= BLEND565_IMPL_COUNT || !blend565_impl_supported(impl)) {
+        return false;
+    }
+    selected = &kernels[impl];
+    return true;
+}
+
+blend565_impl_t blend565_get_impl(void)
+{
+    return (blend565_impl_t)(active_kernels() - kernels);
+}
+
+const char * blend565_impl_name(blend565_impl_t impl)
+{
+    return impl < BLEND565_IMPL_COUNT ? kernels[impl].name : "unknown";
+}
+
+blend565_impl_t blend565_impl_from_name(const char * name)
+{
+    for (int i = 0; i < BLEND565_IMPL_COUNT; i++) {
+        if (strcmp(kernels[i].name, name) == 0) return (blend565_impl_t)i;
+    }
+    return BLEND565_IMPL_COUNT;
+}
+
+uint32_t blend565_selftest(void)
+{
+    static uint16_t src[SELFTEST_MAX_H * SELFTEST_MAX_W];
+    static uint16_t bg[SELFTEST_MAX_H * SELFTEST_MAX_W];
+    static uint16_t ref[SELFTEST_MAX_H * SELFTEST_MAX_W];
+    static uint16_t out[SELFTEST_MAX_H * SELFTEST_MAX_W];
+    static uint8_t mask[SELFTEST_MAX_H * SELFTEST_MAX_W];
+    static const uint8_t opas[] = {0, 1, 2, 3, 4, 127, 128, 250, 252, 253, 255};
+
+    const blend565_kernels_t * prev = active_kernels();
+    uint32_t failures = 0;
+    uint32_t seed = 565;
+
+    for (uint32_t c = 0; c < SELFTEST_CASES; c++) {
+        // Random size, offset inside the buffers (alignment) and stride
+        int32_t stride = SELFTEST_MAX_W;
+        int32_t x0 = selftest_rand(&seed) % 8;
+        int32_t w = 1 + selftest_rand(&seed) % (SELFTEST_MAX_W - x0);
+        int32_t h = 1 + selftest_rand(&seed) % SELFTEST_MAX_H;
+        uint16_t color = (uint16_t)selftest_rand(&seed);
+        uint8_t opa = (c & 1) ? opas[selftest_rand(&seed) % sizeof(opas)] : (uint8_t)selftest_rand(&seed);
+        bool use_mask = (c & 2) != 0;
+        bool use_map = (c & 4) != 0;
+
+        for (int32_t i = 0; i < SELFTEST_MAX_H * SELFTEST_MAX_W; i++) {
+            src[i] = (uint16_t)selftest_rand(&seed);
+            bg[i] = (uint16_t)selftest_rand(&seed);
+            // Bias the mask towards the fully transparent and opaque values
+            int r = selftest_rand(&seed) % 4;
+            mask[i] = r == 0 ? 0 : r == 1 ? 255 : (uint8_t)selftest_rand(&seed);
+        }
+
+        for (int impl = 0; impl < BLEND565_IMPL_COUNT; impl++) {
+            if (!blend565_impl_supported((blend565_impl_t)impl)) continue;
+            selected = &kernels[impl];
+
+            uint16_t * dest = impl == BLEND565_IMPL_SCALAR ? ref : out;
+            memcpy(dest, bg, sizeof(bg));
+            if (use_map) {
+                blend565_map(dest + x0, stride, src + x0, stride, w, h, opa, use_mask ? mask + x0 : NULL, stride);
+            } else {
+                blend565_fill(dest + x0, stride, w, h, color, opa, use_mask ? mask + x0 : NULL, stride);
+            }
+
+            if (impl != BLEND565_IMPL_SCALAR && memcmp(ref, out, sizeof(ref)) != 0) {
+                failures++;
+            }
+        }
+    }
+
+    selected = prev;
+    return failures;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file blend565.h
+ * RGB565 fill and blend kernels with a scalar reference and vectorized variants
+ */
+
+#ifndef BLEND565_H
+#define BLEND565_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    BLEND565_IMPL_SCALAR,   // Portable reference implementation
+    BLEND565_IMPL_SSE41,    // x86 SSE4.1, 8 pixels per iteration
+    BLEND565_IMPL_AVX2,     // x86 AVX2, 16 pixels per iteration
+    BLEND565_IMPL_COUNT
+} blend565_impl_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Fill an area with a color.
+ * Every pixel is mixed with LVGL's `lv_color_mix()` formula for RGB565 (LV_COLOR_MIX_ROUND_OFS 0).
+ * A mask is scaled by `opa` like in LVGL 8.3's masked fill: the mask alone for `opa` >= 253,
+ * `opa` alone where the mask is 255, `mask * opa >> 8` otherwise. All implementations produce the same
+ * pixels. LVGL's own unmasked fills mix premultiplied colors instead and differ by up to 1 per channel,
+ * see test/test_blend565.
+ * @param dest first pixel to write
+ * @param dest_stride distance between two rows of `dest` in pixels
+ * @param w width of the area
+ * @param h height of the area
+ * @param color RGB565 color
+ * @param opa opacity, >= 253 is fully opaque like LV_OPA_MAX
+ * @param mask `w` x `h` opacity mask or NULL
+ * @param mask_stride distance between two rows of `mask` in bytes
+ */
+void blend565_fill(uint16_t * dest, int32_t dest_stride, int32_t w, int32_t h, uint16_t color, uint8_t opa,
+                   const uint8_t * mask, int32_t mask_stride);
+
+/**
+ * Blend an RGB565 image onto an area, mixed like `blend565_fill()`.
+ * A mask is scaled by `opa` like in LVGL 8.3's masked image blending: the mask alone for `opa` >= 254,
+ * `opa` alone where the mask is 253 or more, `mask * opa >> 8` otherwise.
+ * @param dest first pixel to write
+ * @param dest_stride distance between two rows of `dest` in pixels
+ * @param src first pixel to read
+ * @param src_stride distance between two rows of `src` in pixels
+ * @param w width of the area
+ * @param h height of the area
+ * @param opa opacity, >= 253 is fully opaque like LV_OPA_MAX
+ * @param mask `w` x `h` opacity mask or NULL
+ * @param mask_stride distance between two rows of `mask` in bytes
+ */
+void blend565_map(uint16_t * dest, int32_t dest_stride, const uint16_t * src, int32_t src_stride,
+                  int32_t w, int32_t h, uint8_t opa, const uint8_t * mask, int32_t mask_stride);
+
+/**
+ * Check if an implementation can run on this CPU
+ */
+bool blend565_impl_supported(blend565_impl_t impl);
+
+/**
+ * Select the implementation used by `blend565_fill()` and `blend565_map()`
+ * @return false if `impl` is not supported, the current one is kept then
+ */
+bool blend565_set_impl(blend565_impl_t impl);
+
+/**
+ * Get the selected implementation, the fastest supported one by default
+ */
+blend565_impl_t blend565_get_impl(void);
+
+/**
+ * Get a printable name of an implementation
+ */
+const char * blend565_impl_name(blend565_impl_t impl);
+
+/**
+ * Look up an implementation by its name, see `blend565_impl_name()`
+ * @return the implementation or BLEND565_IMPL_COUNT if unknown
+ */
+blend565_impl_t blend565_impl_from_name(const char * name);
+
+/**
+ * Run every supported implementation on random areas, colors, opacities, masks and
+ * misalignments and compare the result with the scalar reference pixel by pixel
+ * @return the number of mismatching test cases, 0 on success
+ */
+uint32_t blend565_selftest(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*BLEND565_H*/
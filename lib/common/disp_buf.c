@@ -0,0 +1,176 @@
+/**
+ * @file disp_buf.c
+ * Runtime-configurable LVGL draw buffer strategy
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disp_buf.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t buf_px_cnt(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res);
+static bool alloc_bufs(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res);
+static void free_bufs(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static disp_buf_alloc_cb_t alloc_fn = malloc;
+static disp_buf_free_cb_t free_fn = free;
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_color_t * buf1;
+static lv_color_t * buf2;
+static disp_buf_config_t active_cfg;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t buf_px_cnt(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    if (cfg->mode != DISP_BUF_MODE_PARTIAL) {
+        return (uint32_t)hor_res * ver_res;
+    }
+
+    uint32_t lines = LV_CLAMP(1, cfg->lines, ver_res);
+    return (uint32_t)hor_res * lines;
+}
+
+static bool alloc_bufs(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    uint32_t px_cnt = buf_px_cnt(cfg, hor_res, ver_res);
+
+    lv_color_t * new_buf1 = alloc_fn(px_cnt * sizeof(lv_color_t));
+    lv_color_t * new_buf2 = cfg->double_buf ? alloc_fn(px_cnt * sizeof(lv_color_t)) : NULL;
+    if (new_buf1 == NULL || (cfg->double_buf && new_buf2 == NULL)) {
+        if (new_buf1) free_fn(new_buf1);
+        if (new_buf2) free_fn(new_buf2);
+        return false;
+    }
+
+    free_bufs();
+    buf1 = new_buf1;
+    buf2 = new_buf2;
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, px_cnt);
+    active_cfg = *cfg;
+    return true;
+}
+
+static void free_bufs(void)
+{
+    if (buf1) free_fn(buf1);
+    if (buf2) free_fn(buf2);
+    buf1 = NULL;
+    buf2 = NULL;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void disp_buf_set_allocator(disp_buf_alloc_cb_t alloc_cb, disp_buf_free_cb_t free_cb)
+{
+    alloc_fn = alloc_cb;
+    free_fn = free_cb;
+}
+
+bool disp_buf_init(lv_disp_drv_t * drv, const disp_buf_config_t * cfg)
+{
+    if (!alloc_bufs(cfg, drv->hor_res, drv->ver_res)) {
+        return false;
+    }
+
+    drv->draw_buf = &draw_buf;
+    drv->full_refresh = cfg->mode == DISP_BUF_MODE_FULL;
+    drv->direct_mode = cfg->mode == DISP_BUF_MODE_DIRECT;
+    return true;
+}
+
+bool disp_buf_reconfigure(lv_disp_t * disp, const disp_buf_config_t * cfg)
+{
+    lv_disp_drv_t * drv = disp->driver;
+
+    // Never pull a buffer from under a flush that is still in progress
+    while (draw_buf.flushing) {
+        if (drv->wait_cb) drv->wait_cb(drv);
+    }
+
+    if (!alloc_bufs(cfg, drv->hor_res, drv->ver_res)) {
+        return false;
+    }
+
+    drv->draw_buf = &draw_buf;
+    drv->full_refresh = cfg->mode == DISP_BUF_MODE_FULL;
+    drv->direct_mode = cfg->mode == DISP_BUF_MODE_DIRECT;
+
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_obj_invalidate(lv_disp_get_layer_top(disp));
+    lv_obj_invalidate(lv_disp_get_layer_sys(disp));
+    return true;
+}
+
+const disp_buf_config_t * disp_buf_get_config(void)
+{
+    return &active_cfg;
+}
+
+size_t disp_buf_get_ram_size(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    size_t size = buf_px_cnt(cfg, hor_res, ver_res) * sizeof(lv_color_t);
+    return cfg->double_buf ? size * 2 : size;
+}
+
+bool disp_buf_parse_config(const char * spec, disp_buf_config_t * cfg)
+{
+    disp_buf_config_t parsed = { DISP_BUF_MODE_PARTIAL, 0, false };
+    const char * p = spec;
+
+    if (strncmp(p, "full", 4) == 0) {
+        parsed.mode = DISP_BUF_MODE_FULL;
+        p += 4;
+    } else if (strncmp(p, "direct", 6) == 0) {
+        parsed.mode = DISP_BUF_MODE_DIRECT;
+        p += 6;
+    } else {
+        char * end;
+        long lines = strtol(p, &end, 10);
+        if (end == p || lines <= 0 || lines > UINT16_MAX) {
+            return false;
+        }
+        parsed.lines = (uint16_t)lines;
+        p = end;
+    }
+
+    if (strcmp(p, "x2") == 0) {
+        parsed.double_buf = true;
+    } else if (*p != '\0') {
+        return false;
+    }
+
+    *cfg = parsed;
+    return true;
+}
+
+void disp_buf_config_to_str(const disp_buf_config_t * cfg, char * buf, size_t len)
+{
+    const char * suffix = cfg->double_buf ? "x2" : "";
+
+    switch (cfg->mode) {
+        case DISP_BUF_MODE_FULL:
+            snprintf(buf, len, "full%s", suffix);
+            break;
+        case DISP_BUF_MODE_DIRECT:
+            snprintf(buf, len, "direct%s", suffix);
+            break;
+        default:
+            snprintf(buf, len, "%u%s", cfg->lines, suffix);
+            break;
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file disp_buf.h
+ * Runtime-configurable LVGL draw buffer strategy
+ */
+
+#ifndef DISP_BUF_H
+#define DISP_BUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DISP_BUF_CONFIG_STR_MAX 24
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    DISP_BUF_MODE_PARTIAL,  // Render invalidated areas in `lines` tall chunks
+    DISP_BUF_MODE_FULL,     // Redraw the whole screen on every refresh
+    DISP_BUF_MODE_DIRECT,   // Screen sized buffer, only invalidated areas are redrawn
+} disp_buf_mode_t;
+
+typedef struct {
+    disp_buf_mode_t mode;
+    uint16_t lines;         // Buffer height in PARTIAL mode, ignored otherwise
+    bool double_buf;
+} disp_buf_config_t;
+
+typedef void * (*disp_buf_alloc_cb_t)(size_t size);
+typedef void (*disp_buf_free_cb_t)(void * ptr);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Override the allocator used for draw buffers (defaults to malloc/free)
+ * @param alloc_cb allocation function
+ * @param free_cb matching free function
+ */
+void disp_buf_set_allocator(disp_buf_alloc_cb_t alloc_cb, disp_buf_free_cb_t free_cb);
+
+/**
+ * Allocate the draw buffers and attach them to a display driver before it is registered
+ * @param drv the display driver, `hor_res` and `ver_res` must already be set
+ * @param cfg the buffer strategy to use
+ * @return true on success
+ */
+bool disp_buf_init(lv_disp_drv_t * drv, const disp_buf_config_t * cfg);
+
+/**
+ * Switch the draw buffer strategy of a registered display and invalidate it
+ * @param disp the display initialized with `disp_buf_init()`
+ * @param cfg the new buffer strategy
+ * @return true on success, on failure the previous strategy is kept
+ */
+bool disp_buf_reconfigure(lv_disp_t * disp, const disp_buf_config_t * cfg);
+
+/**
+ * Get the currently active buffer strategy
+ */
+const disp_buf_config_t * disp_buf_get_config(void);
+
+/**
+ * Get the RAM needed by a buffer strategy
+ * @param cfg the buffer strategy
+ * @param hor_res horizontal resolution of the display
+ * @param ver_res vertical resolution of the display
+ * @return size in bytes of all draw buffers
+ */
+size_t disp_buf_get_ram_size(const disp_buf_config_t * cfg, lv_coord_t hor_res, lv_coord_t ver_res);
+
+/**
+ * Parse a buffer strategy, e.g. "10", "200x2", "full", "directx2"
+ * A number selects PARTIAL mode with that many lines, the "x2" suffix enables double buffering.
+ * @param spec the string to parse
+ * @param cfg store the result here
+ * @return true if `spec` was valid
+ */
+bool disp_buf_parse_config(const char * spec, disp_buf_config_t * cfg);
+
+/**
+ * Format a buffer strategy in the syntax accepted by `disp_buf_parse_config()`
+ * @param cfg the buffer strategy
+ * @param buf output buffer, at least DISP_BUF_CONFIG_STR_MAX bytes
+ * @param len size of `buf`
+ */
+void disp_buf_config_to_str(const disp_buf_config_t * cfg, char * buf, size_t len);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*DISP_BUF_H*/
@@ -0,0 +1,107 @@
+/**
+ * @file draw_simd.c
+ * LVGL software draw context whose RGB565 blending runs on the blend565 kernels
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "draw_simd.h"
+#include "blend565.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DRAW_SIMD_SUPPORTED (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+static void draw_ctx_deinit(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+static void simd_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static bool enabled = true;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = simd_blend;
+}
+
+static void draw_ctx_deinit(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_deinit_ctx(drv, draw_ctx);
+}
+
+/* Same clipping and offset rules as lv_draw_sw_blend_basic() */
+static void simd_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
+{
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+
+    if (!enabled || !DRAW_SIMD_SUPPORTED || dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+        disp->driver->set_px_cb != NULL || disp->driver->screen_transp) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    const lv_opa_t * mask;
+    if (dsc->mask_buf == NULL) mask = NULL;
+    else if (dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) return;
+    else if (dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) mask = NULL;
+    else mask = dsc->mask_buf;
+
+    lv_area_t blend_area;
+    if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
+
+    lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    uint16_t * dest = (uint16_t *)draw_ctx->buf;
+    dest += dest_stride * (blend_area.y1 - draw_ctx->buf_area->y1) + (blend_area.x1 - draw_ctx->buf_area->x1);
+
+    lv_coord_t mask_stride = 0;
+    if (mask) {
+        mask_stride = lv_area_get_width(dsc->mask_area);
+        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+    }
+
+    int32_t w = lv_area_get_width(&blend_area);
+    int32_t h = lv_area_get_height(&blend_area);
+
+    if (dsc->src_buf == NULL) {
+        blend565_fill(dest, dest_stride, w, h, dsc->color.full, dsc->opa, mask, mask_stride);
+    } else {
+        // Image copies: decoded images arrive here as an RGB565 map
+        lv_coord_t src_stride = lv_area_get_width(dsc->blend_area);
+        const uint16_t * src = (const uint16_t *)dsc->src_buf;
+        src += src_stride * (blend_area.y1 - dsc->blend_area->y1) + (blend_area.x1 - dsc->blend_area->x1);
+        blend565_map(dest, dest_stride, src, src_stride, w, h, dsc->opa, mask, mask_stride);
+    }
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void draw_simd_attach(lv_disp_drv_t * drv)
+{
+    drv->draw_ctx_init = draw_ctx_init;
+    drv->draw_ctx_deinit = draw_ctx_deinit;
+    drv->draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
+}
+
+void draw_simd_set_enabled(bool en)
+{
+    enabled = en;
+}
+
+bool draw_simd_is_enabled(void)
+{
+    return enabled;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file draw_simd.h
+ * LVGL software draw context whose RGB565 blending runs on the blend565 kernels
+ */
+
+#ifndef DRAW_SIMD_H
+#define DRAW_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include "lvgl.h"
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Use the draw context on a display driver before it is registered.
+ * Rectangle fills, letters, masked areas and images all end up in the software renderer's
+ * `blend` callback which is replaced here. Blend modes other than normal, `set_px_cb` and
+ * transparent screens are handed back to LVGL's own blending.
+ * @param drv the display driver
+ */
+void draw_simd_attach(lv_disp_drv_t * drv);
+
+/**
+ * Switch between the blend565 kernels and LVGL's built-in blending at runtime
+ * @param en true to use the blend565 kernels (default)
+ */
+void draw_simd_set_enabled(bool en);
+
+/**
+ * Check if the blend565 kernels are in use
+ */
+bool draw_simd_is_enabled(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*DRAW_SIMD_H*/
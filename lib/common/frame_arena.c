@@ -0,0 +1,70 @@
+/**
+ * @file frame_arena.c
+ * Bump allocator for strings needed only while a received message is handled, e.g. the zero
+ * terminated object names cut out of it. Reset after each message, never freed one by one.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "frame_arena.h"
+#include "metrics.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ALIGN   8
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t arena[FRAME_ARENA_SIZE] __attribute__((aligned(ALIGN)));
+static frame_arena_stats_t stats;
+static uint32_t * metric_peak;
+static uint32_t * metric_overflows;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void * frame_arena_alloc(size_t size)
+{
+    size_t rounded = (size + ALIGN - 1) & ~(size_t)(ALIGN - 1);
+    if (rounded > FRAME_ARENA_SIZE - stats.used) {
+        stats.overflows++;
+        return NULL;
+    }
+
+    void * p = &arena[stats.used];
+    stats.used += (uint32_t)rounded;
+    if (stats.used > stats.peak) stats.peak = stats.used;
+    return p;
+}
+
+char * frame_arena_strndup(const char * str, size_t len)
+{
+    char * p = frame_arena_alloc(len + 1);
+    if (p == NULL) return NULL;
+
+    memcpy(p, str, len);
+    p[len] = '\0';
+    return p;
+}
+
+void frame_arena_reset(void)
+{
+    if (metric_peak == NULL) {
+        metric_peak = metrics_get("arena.peak");
+        metric_overflows = metrics_get("arena.overflows");
+    }
+    *metric_peak = stats.peak;
+    *metric_overflows = stats.overflows;
+
+    stats.used = 0;
+}
+
+void frame_arena_get_stats(frame_arena_stats_t * out)
+{
+    *out = stats;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file frame_arena.h
+ * Bump allocator for strings needed only while a received message is handled, e.g. the zero
+ * terminated object names cut out of it. Reset after each message, never freed one by one.
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef FRAME_ARENA_SIZE
+#define FRAME_ARENA_SIZE    2048
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t used;          // Bytes taken for the current message
+    uint32_t peak;          // Most bytes taken for a message
+    uint32_t overflows;     // Allocations that didn't fit
+} frame_arena_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Take a block valid until the next frame_arena_reset()
+ * @param size size in bytes
+ * @return the block, aligned for any type, NULL if the arena is full for this message
+ */
+void * frame_arena_alloc(size_t size);
+
+/**
+ * Copy characters into the arena and terminate them
+ * @param str the characters, not necessarily terminated
+ * @param len number of characters
+ * @return the copy, NULL if the arena is full for this message
+ */
+char * frame_arena_strndup(const char * str, size_t len);
+
+/**
+ * Release everything taken since the last reset, call it once a message is handled
+ */
+void frame_arena_reset(void);
+
+/**
+ * Get the usage of the arena
+ */
+void frame_arena_get_stats(frame_arena_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*FRAME_ARENA_H*/
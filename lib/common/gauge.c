@@ -0,0 +1,427 @@
+/**
+ * @file gauge.c
+ * Dial gauge with a cached dial image and a needle drawn on top of it
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include "gauge.h"
+#include "mem_place.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &gauge_class
+
+#define ANGLE_RANGE     270     // Degrees covered by the scale
+#define ROTATION        135     // Angle of the scale's start, 0 is 3 o'clock
+#define TICK_CNT        31
+#define MAJOR_NTH       5       // Every 5th tick is a labelled major one
+#define ZONE_WIDTH      6
+#define MAX_STEPS       512     // Needle positions in the table
+#define NEEDLE_MARGIN   2       // Anti-aliased edge around the needle
+#define NEEDLE_COLOR    LV_COLOR_MAKE(0x9E, 0x9E, 0x9E)     // lv_palette_main(LV_PALETTE_GREY)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_obj_t obj;
+    int32_t min;
+    int32_t max;
+    int32_t value;
+    int32_t zone_start;
+    int32_t zone_end;
+    lv_color_t zone_color;
+    bool zone;
+    lv_img_dsc_t dial;          // Snapshot of the dial
+    void * dial_buf;
+    lv_coord_t dial_x;          // Position of the snapshot relative to the object
+    lv_coord_t dial_y;
+    lv_timer_t * dial_timer;    // Pending dial render
+    lv_coord_t center_x;        // Needle pivot relative to the object
+    lv_coord_t center_y;
+    lv_point_t * tips;          // Needle tip relative to the pivot, one per step
+    uint16_t step_cnt;
+    uint16_t step;              // Step of the drawn needle
+    gauge_stats_t stats;
+} gauge_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void gauge_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void gauge_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void gauge_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void update_needle_table(gauge_t * gauge);
+static void schedule_dial(gauge_t * gauge);
+static void dial_timer_cb(lv_timer_t * timer);
+static void render_dial(gauge_t * gauge);
+static void free_dial(gauge_t * gauge);
+static void draw_main(lv_event_t * e);
+static void needle_area(const gauge_t * gauge, uint16_t step, lv_area_t * area);
+static uint16_t value_to_step(const gauge_t * gauge, int32_t value);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t gauge_class = {
+    .constructor_cb = gauge_constructor,
+    .destructor_cb = gauge_destructor,
+    .event_cb = gauge_event,
+    .width_def = LV_DPI_DEF * 2,
+    .height_def = LV_DPI_DEF * 2,
+    .instance_size = sizeof(gauge_t),
+    .base_class = &lv_obj_class
+};
+
+// The dial brings its own background, the object only holds it
+static const lv_style_const_prop_t style_main_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_TRANSP),
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    {.prop = LV_STYLE_PROP_INV}
+};
+static LV_STYLE_CONST_INIT(style_main, style_main_props);
+
+static const lv_style_const_prop_t style_needle_props[] = {
+    LV_STYLE_CONST_LINE_WIDTH(4),
+    LV_STYLE_CONST_LINE_ROUNDED(true),
+    LV_STYLE_CONST_LINE_COLOR(NEEDLE_COLOR),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BG_COLOR(NEEDLE_COLOR),
+    {.prop = LV_STYLE_PROP_INV}
+};
+static LV_STYLE_CONST_INIT(style_needle, style_needle_props);
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void gauge_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    gauge_t * gauge = (gauge_t *)obj;
+
+    gauge->min = 0;
+    gauge->max = 100;
+
+    // Shared by all gauges, styles added later or local ones override them
+    lv_obj_add_style(obj, (lv_style_t *)&style_main, LV_PART_MAIN);
+    lv_obj_add_style(obj, (lv_style_t *)&style_needle, LV_PART_INDICATOR);
+
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+}
+
+static void gauge_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    gauge_t * gauge = (gauge_t *)obj;
+
+    if (gauge->dial_timer) lv_timer_del(gauge->dial_timer);
+    gauge->dial_timer = NULL;
+    free_dial(gauge);
+    if (gauge->tips) lv_mem_free(gauge->tips);
+    gauge->tips = NULL;
+}
+
+static void gauge_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    (void)class_p;
+
+    // Call the ancestor's event handler
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) return;
+
+    lv_event_code_t code = lv_event_get_code(e);
+    gauge_t * gauge = (gauge_t *)lv_event_get_target(e);
+
+    if (code == LV_EVENT_SIZE_CHANGED || code == LV_EVENT_STYLE_CHANGED) {
+        update_needle_table(gauge);
+        schedule_dial(gauge);
+        lv_obj_invalidate(&gauge->obj);
+    }
+    else if (code == LV_EVENT_DRAW_MAIN) {
+        draw_main(e);
+    }
+}
+
+/**
+ * Compute the needle tip of every step with the fixed point sine of LVGL,
+ * interpolated between whole degrees
+ */
+static void update_needle_table(gauge_t * gauge)
+{
+    lv_obj_t * obj = &gauge->obj;
+    lv_area_t content;
+    lv_obj_get_content_coords(obj, &content);
+
+    gauge->center_x = content.x1 - obj->coords.x1 + lv_area_get_width(&content) / 2;
+    gauge->center_y = content.y1 - obj->coords.y1 + lv_area_get_height(&content) / 2;
+
+    int32_t range = gauge->max - gauge->min;
+    uint16_t step_cnt = (uint16_t)LV_CLAMP(1, range, MAX_STEPS - 1) + 1;
+    if (step_cnt != gauge->step_cnt) {
+        if (gauge->tips) lv_mem_free(gauge->tips);
+        gauge->tips = lv_mem_alloc(step_cnt * sizeof(lv_point_t));
+        LV_ASSERT_MALLOC(gauge->tips);
+        if (gauge->tips == NULL) {
+            gauge->step_cnt = 0;
+            return;
+        }
+        gauge->step_cnt = step_cnt;
+    }
+
+    // The needle ends just inside the ticks
+    int32_t radius = LV_MIN(lv_area_get_width(&content), lv_area_get_height(&content)) / 2;
+    int32_t len = radius * 3 / 4;
+
+    for (uint16_t i = 0; i < step_cnt; i++) {
+        int32_t angle10 = ROTATION * 10 + (int32_t)i * ANGLE_RANGE * 10 / (step_cnt - 1);
+        int16_t angle = (int16_t)((angle10 / 10) % 360);
+        int32_t frac = angle10 % 10;
+        int32_t sin_a = lv_trigo_sin(angle);
+        int32_t cos_a = lv_trigo_cos(angle);
+        int32_t sin_v = sin_a + (lv_trigo_sin(angle + 1) - sin_a) * frac / 10;
+        int32_t cos_v = cos_a + (lv_trigo_cos(angle + 1) - cos_a) * frac / 10;
+        gauge->tips[i].x = (lv_coord_t)((cos_v * len) >> LV_TRIGO_SHIFT);
+        gauge->tips[i].y = (lv_coord_t)((sin_v * len) >> LV_TRIGO_SHIFT);
+    }
+
+    gauge->step = value_to_step(gauge, gauge->value);
+}
+
+/**
+ * Render the dial on the next timer run. It is not done right away because size and style
+ * changes arrive during layout updates, where a meter can't be laid out and snapshotted.
+ */
+static void schedule_dial(gauge_t * gauge)
+{
+    if (gauge->dial_timer) return;
+
+    gauge->dial_timer = lv_timer_create(dial_timer_cb, 0, gauge);
+    lv_timer_set_repeat_count(gauge->dial_timer, 1);
+}
+
+static void dial_timer_cb(lv_timer_t * timer)
+{
+    gauge_t * gauge = timer->user_data;
+    gauge->dial_timer = NULL;   // Deleted by LVGL after this run
+
+    render_dial(gauge);
+    lv_obj_invalidate(&gauge->obj);
+}
+
+/**
+ * Draw the scale with a temporary meter and keep a snapshot of it
+ */
+static void render_dial(gauge_t * gauge)
+{
+    lv_obj_t * obj = &gauge->obj;
+
+    free_dial(gauge);
+
+    lv_area_t content;
+    lv_obj_get_content_coords(obj, &content);
+    lv_coord_t size = LV_MIN(lv_area_get_width(&content), lv_area_get_height(&content));
+    if (size <= 0) return;
+
+    // A screen of its own, so the meter doesn't disturb the layout of the gauge's parent
+    lv_obj_t * meter = lv_meter_create(NULL);
+    lv_obj_set_size(meter, size, size);
+
+    lv_meter_scale_t * scale = lv_meter_add_scale(meter);
+    lv_color_t tick_color = lv_palette_main(LV_PALETTE_GREY);
+    lv_meter_set_scale_ticks(meter, scale, TICK_CNT, 2, 10, tick_color);
+    lv_meter_set_scale_major_ticks(meter, scale, MAJOR_NTH, 4, 15, lv_obj_get_style_text_color(obj, LV_PART_MAIN), 10);
+    lv_meter_set_scale_range(meter, scale, gauge->min, gauge->max, ANGLE_RANGE, ROTATION);
+
+    if (gauge->zone) {
+        lv_meter_indicator_t * arc = lv_meter_add_arc(meter, scale, ZONE_WIDTH, gauge->zone_color, 0);
+        lv_meter_set_indicator_start_value(meter, arc, gauge->zone_start);
+        lv_meter_set_indicator_end_value(meter, arc, gauge->zone_end);
+    }
+
+    lv_obj_update_layout(meter);
+
+    uint32_t buf_size = lv_snapshot_buf_size_needed(meter, LV_IMG_CF_TRUE_COLOR_ALPHA);
+    gauge->dial_buf = buf_size ? mem_place_alloc(buf_size, MEM_PLACE_COLD) : NULL;
+    if (gauge->dial_buf == NULL ||
+        lv_snapshot_take_to_buf(meter, LV_IMG_CF_TRUE_COLOR_ALPHA, &gauge->dial, gauge->dial_buf, buf_size) != LV_RES_OK) {
+        LV_LOG_WARN("gauge: can't snapshot a %dx%d dial", (int)size, (int)size);
+        free_dial(gauge);
+    }
+    else {
+        // The snapshot includes the meter's extra draw area (e.g. shadow) on every side
+        lv_coord_t ext = (lv_coord_t)(gauge->dial.header.w - size) / 2;
+        gauge->dial_x = gauge->center_x - size / 2 - ext;
+        gauge->dial_y = gauge->center_y - size / 2 - ext;
+        gauge->stats.dial_renders++;
+    }
+
+    lv_obj_del(meter);
+}
+
+static void free_dial(gauge_t * gauge)
+{
+    // The image cache may still point to the old pixels
+    lv_img_cache_invalidate_src(&gauge->dial);
+
+    mem_place_free(gauge->dial_buf);
+    gauge->dial_buf = NULL;
+    gauge->dial.data = NULL;
+}
+
+static void draw_main(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    gauge_t * gauge = (gauge_t *)obj;
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    if (gauge->dial_buf) {
+        lv_area_t dial_area;
+        dial_area.x1 = obj->coords.x1 + gauge->dial_x;
+        dial_area.y1 = obj->coords.y1 + gauge->dial_y;
+        dial_area.x2 = dial_area.x1 + gauge->dial.header.w - 1;
+        dial_area.y2 = dial_area.y1 + gauge->dial.header.h - 1;
+
+        lv_area_t copied;
+        if (_lv_area_intersect(&copied, &dial_area, draw_ctx->clip_area)) {
+            mem_place_touch(gauge->dial_buf, lv_area_get_size(&copied) * LV_IMG_PX_SIZE_ALPHA_BYTE);
+            lv_draw_img_dsc_t img_dsc;
+            lv_draw_img_dsc_init(&img_dsc);
+            lv_draw_img(draw_ctx, &img_dsc, &dial_area, &gauge->dial);
+        }
+    }
+
+    if (gauge->step_cnt == 0) return;
+
+    lv_area_t area;
+    needle_area(gauge, gauge->step, &area);
+    if (!_lv_area_is_on(&area, draw_ctx->clip_area)) return;
+
+    lv_point_t p1;
+    p1.x = obj->coords.x1 + gauge->center_x;
+    p1.y = obj->coords.y1 + gauge->center_y;
+    lv_point_t p2;
+    p2.x = p1.x + gauge->tips[gauge->step].x;
+    p2.y = p1.y + gauge->tips[gauge->step].y;
+
+    lv_draw_line_dsc_t line_dsc;
+    lv_draw_line_dsc_init(&line_dsc);
+    lv_obj_init_draw_line_dsc(obj, LV_PART_INDICATOR, &line_dsc);
+    lv_draw_line(draw_ctx, &line_dsc, &p1, &p2);
+
+    // Cap over the pivot
+    lv_draw_rect_dsc_t cap_dsc;
+    lv_draw_rect_dsc_init(&cap_dsc);
+    lv_obj_init_draw_rect_dsc(obj, LV_PART_INDICATOR, &cap_dsc);
+    cap_dsc.radius = LV_RADIUS_CIRCLE;
+    lv_area_t cap = {p1.x - line_dsc.width, p1.y - line_dsc.width, p1.x + line_dsc.width, p1.y + line_dsc.width};
+    lv_draw_rect(draw_ctx, &cap_dsc, &cap);
+}
+
+/**
+ * Get the absolute area of the needle and its cap at a step
+ */
+static void needle_area(const gauge_t * gauge, uint16_t step, lv_area_t * area)
+{
+    const lv_obj_t * obj = &gauge->obj;
+    lv_coord_t cx = obj->coords.x1 + gauge->center_x;
+    lv_coord_t cy = obj->coords.y1 + gauge->center_y;
+    lv_coord_t tx = cx + gauge->tips[step].x;
+    lv_coord_t ty = cy + gauge->tips[step].y;
+
+    // The cap has the radius of the line width, rounded ends stick out by half of it
+    lv_coord_t margin = lv_obj_get_style_line_width(obj, LV_PART_INDICATOR) + NEEDLE_MARGIN;
+    area->x1 = LV_MIN(cx, tx) - margin;
+    area->y1 = LV_MIN(cy, ty) - margin;
+    area->x2 = LV_MAX(cx, tx) + margin;
+    area->y2 = LV_MAX(cy, ty) + margin;
+}
+
+static uint16_t value_to_step(const gauge_t * gauge, int32_t value)
+{
+    int32_t range = gauge->max - gauge->min;
+    if (range <= 0 || gauge->step_cnt == 0) return 0;
+
+    value = LV_CLAMP(gauge->min, value, gauge->max);
+    return (uint16_t)((value - gauge->min) * (gauge->step_cnt - 1) / range);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * gauge_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void gauge_set_range(lv_obj_t * obj, int32_t min, int32_t max)
+{
+    gauge_t * gauge = (gauge_t *)obj;
+    if (gauge->min == min && gauge->max == max) return;
+
+    gauge->min = min;
+    gauge->max = max;
+    update_needle_table(gauge);
+    schedule_dial(gauge);
+    lv_obj_invalidate(obj);
+}
+
+void gauge_set_zone(lv_obj_t * obj, int32_t start, int32_t end, lv_color_t color)
+{
+    gauge_t * gauge = (gauge_t *)obj;
+
+    gauge->zone_start = start;
+    gauge->zone_end = end;
+    gauge->zone_color = color;
+    gauge->zone = true;
+    schedule_dial(gauge);
+}
+
+void gauge_set_value(lv_obj_t * obj, int32_t value)
+{
+    gauge_t * gauge = (gauge_t *)obj;
+
+    gauge->value = value;
+    uint16_t step = value_to_step(gauge, value);
+    if (step == gauge->step || gauge->step_cnt == 0) {
+        gauge->step = step;
+        gauge->stats.skipped++;
+        return;
+    }
+
+    // Only the old and the new needle are drawn again, the dial is a copy of the snapshot
+    lv_area_t old_area;
+    lv_area_t new_area;
+    needle_area(gauge, gauge->step, &old_area);
+    needle_area(gauge, step, &new_area);
+    gauge->step = step;
+
+    lv_obj_invalidate_area(obj, &old_area);
+    lv_obj_invalidate_area(obj, &new_area);
+    gauge->stats.updates++;
+    gauge->stats.invalidated_px += lv_area_get_size(&old_area) + lv_area_get_size(&new_area);
+}
+
+int32_t gauge_get_value(const lv_obj_t * obj)
+{
+    const gauge_t * gauge = (const gauge_t *)obj;
+    return gauge->value;
+}
+
+void gauge_get_stats(const lv_obj_t * obj, gauge_stats_t * stats)
+{
+    const gauge_t * gauge = (const gauge_t *)obj;
+    *stats = gauge->stats;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file gauge.h
+ * Dial gauge with a cached dial image and a needle drawn on top of it
+ */
+
+#ifndef GAUGE_H
+#define GAUGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t dial_renders;      // Snapshots of the dial, once per size, style or scale change
+    uint32_t updates;           // Values that moved the needle
+    uint32_t skipped;           // Values that left the needle where it was
+    uint32_t invalidated_px;    // Pixels invalidated by needle moves
+} gauge_stats_t;
+
+extern const lv_obj_class_t gauge_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a gauge. The dial (scale, labels and zone) is rendered by an `lv_meter` once and
+ * kept as an image, a value change only redraws the area of the old and the new needle.
+ * Style the needle with the line and bg properties of LV_PART_INDICATOR.
+ * @param parent pointer to an object, it will be the parent of the new gauge
+ * @return pointer to the created gauge
+ */
+lv_obj_t * gauge_create(lv_obj_t * parent);
+
+/**
+ * Set the range of the scale
+ * @param obj pointer to a gauge object
+ * @param min value at the start of the scale
+ * @param max value at the end of the scale
+ */
+void gauge_set_range(lv_obj_t * obj, int32_t min, int32_t max);
+
+/**
+ * Highlight a zone of the scale, e.g. the brew temperature
+ * @param obj pointer to a gauge object
+ * @param start first value of the zone
+ * @param end last value of the zone
+ * @param color color of the zone
+ */
+void gauge_set_zone(lv_obj_t * obj, int32_t start, int32_t end, lv_color_t color);
+
+/**
+ * Move the needle
+ * @param obj pointer to a gauge object
+ * @param value the new value, clamped to the range
+ */
+void gauge_set_value(lv_obj_t * obj, int32_t value);
+
+/**
+ * Get the value shown by the needle
+ * @param obj pointer to a gauge object
+ */
+int32_t gauge_get_value(const lv_obj_t * obj);
+
+/**
+ * Get the update statistics of a gauge
+ * @param obj pointer to a gauge object
+ * @param stats store the statistics here
+ */
+void gauge_get_stats(const lv_obj_t * obj, gauge_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*GAUGE_H*/
@@ -0,0 +1,111 @@
+/**
+ * @file glyph_atlas.c
+ * Pre-rasterized digits, signs and unit letters of the readout fonts, generated at build time
+ * by scripts/glyph-atlas.py. A glyph is drawn with one blend through its opacity bytes, without
+ * the glyph lookup and bit unpacking of lv_draw_letter().
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "glyph_atlas.h"
+#include "metrics.h"
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+// Written to the build directory, without it every readout draws with its font
+#ifdef __has_include
+    #if __has_include("glyph_atlas_data.h")
+        #include "glyph_atlas_data.h"
+        #define HAS_ATLAS_DATA 1
+    #endif
+#endif
+
+#ifndef HAS_ATLAS_DATA
+static const glyph_atlas_t glyph_atlases[] = {
+    {NULL, NULL, NULL, 0}
+};
+#endif
+
+static uint32_t * metric_drawn;
+static uint32_t * metric_fallbacks;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+const glyph_atlas_t * glyph_atlas_find(const lv_font_t * font)
+{
+    for (const glyph_atlas_t * atlas = glyph_atlases; atlas->font != NULL; atlas++) {
+        if (atlas->font == font) return atlas;
+    }
+    return NULL;
+}
+
+const glyph_atlas_glyph_t * glyph_atlas_get_glyph(const glyph_atlas_t * atlas, uint32_t letter)
+{
+    uint32_t lo = 0;
+    uint32_t hi = atlas->glyph_cnt;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (atlas->glyphs[mid].letter < letter) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < atlas->glyph_cnt && atlas->glyphs[lo].letter == letter ? &atlas->glyphs[lo] : NULL;
+}
+
+bool glyph_atlas_has_text(const glyph_atlas_t * atlas, const char * text)
+{
+    uint32_t i = 0;
+    while (text[i] != '\0') {
+        if (glyph_atlas_get_glyph(atlas, _lv_txt_encoded_next(text, &i)) == NULL) return false;
+    }
+    return true;
+}
+
+bool glyph_atlas_draw(lv_draw_ctx_t * draw_ctx, const glyph_atlas_t * atlas, const lv_draw_label_dsc_t * dsc,
+                      const lv_point_t * pos, const glyph_atlas_glyph_t * glyph)
+{
+    if (metric_drawn == NULL) {
+        metric_drawn = metrics_get("glyph_atlas.drawn");
+        metric_fallbacks = metrics_get("glyph_atlas.fallbacks");
+    }
+
+    if (glyph == NULL) {
+        (*metric_fallbacks)++;
+        return false;
+    }
+    if (glyph->box_w == 0 || glyph->box_h == 0 || dsc->opa <= LV_OPA_MIN) return true;
+
+    // Placed in the line like lv_draw_letter() does
+    const lv_font_t * font = atlas->font;
+    lv_area_t area;
+    area.x1 = pos->x + glyph->ofs_x;
+    area.y1 = pos->y + (font->line_height - font->base_line) - glyph->box_h - glyph->ofs_y;
+    area.x2 = area.x1 + glyph->box_w - 1;
+    area.y2 = area.y1 + glyph->box_h - 1;
+    if (!_lv_area_is_on(&area, draw_ctx->clip_area)) return true;
+
+    // Rounded corners and other masks are applied by LVGL's own glyph drawing
+    if (lv_draw_mask_is_any(&area)) {
+        (*metric_fallbacks)++;
+        return false;
+    }
+
+    // The glyph is the mask of the whole area, the blending clips it and only reads it
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.blend_area = &area;
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.mask_buf = (lv_opa_t *)&atlas->bitmap[glyph->offset];
+    blend_dsc.mask_area = &area;
+    blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    blend_dsc.blend_mode = dsc->blend_mode;
+    lv_draw_sw_blend(draw_ctx, &blend_dsc);
+
+    (*metric_drawn)++;
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file glyph_atlas.h
+ * Pre-rasterized digits, signs and unit letters of the readout fonts, generated at build time
+ * by scripts/glyph-atlas.py. A glyph is drawn with one blend through its opacity bytes, without
+ * the glyph lookup and bit unpacking of lv_draw_letter().
+ */
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t letter;        // Unicode code point
+    uint32_t offset;        // Start of the glyph in the bitmap of the atlas
+    uint8_t adv_w;          // Advance in pixels, as lv_font_get_glyph_width()
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;           // Position in the line like lv_font_glyph_dsc_t
+    int8_t ofs_y;
+} glyph_atlas_glyph_t;
+
+typedef struct {
+    const lv_font_t * font;                 // Font the glyphs were taken from
+    const uint8_t * bitmap;                 // Opacity of each pixel, glyph after glyph, row by row
+    const glyph_atlas_glyph_t * glyphs;     // Sorted by letter
+    uint16_t glyph_cnt;
+} glyph_atlas_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get the atlas of a font
+ * @param font pointer to a font
+ * @return the atlas, NULL if the font has none or the atlas wasn't generated for this build
+ */
+const glyph_atlas_t * glyph_atlas_find(const lv_font_t * font);
+
+/**
+ * Get a glyph of an atlas
+ * @param atlas pointer to an atlas
+ * @param letter Unicode code point
+ * @return the glyph, NULL if the atlas doesn't have it
+ */
+const glyph_atlas_glyph_t * glyph_atlas_get_glyph(const glyph_atlas_t * atlas, uint32_t letter);
+
+/**
+ * Check if an atlas has every letter of a text
+ * @param atlas pointer to an atlas
+ * @param text UTF-8 text
+ */
+bool glyph_atlas_has_text(const glyph_atlas_t * atlas, const char * text);
+
+/**
+ * Draw a glyph of an atlas like lv_draw_letter(), with the color, opacity and blend mode of `dsc`
+ * @param draw_ctx pointer to the current draw context
+ * @param atlas pointer to an atlas
+ * @param dsc label draw descriptor
+ * @param pos top left corner of the line the glyph is in
+ * @param glyph a glyph of `atlas`, see glyph_atlas_get_glyph()
+ * @return false if nothing was drawn because `glyph` is NULL or draw masks are active,
+ *         draw the letter with lv_draw_letter() then
+ */
+bool glyph_atlas_draw(lv_draw_ctx_t * draw_ctx, const glyph_atlas_t * atlas, const lv_draw_label_dsc_t * dsc,
+                      const lv_point_t * pos, const glyph_atlas_glyph_t * glyph);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*GLYPH_ATLAS_H*/
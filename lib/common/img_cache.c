@@ -0,0 +1,278 @@
+/**
+ * @file img_cache.c
+ * Cache of decoded images in place of LVGL's image cache. Indexed images, which LVGL would convert
+ * line by line on every draw, are decoded once as a whole and kept in PSRAM, the least recently used
+ * are evicted to stay within IMG_CACHE_SIZE bytes. Assets can be decoded ahead of time between frames,
+ * so showing them never decodes while rendering. Compressed IMG_RLE_CF images are left to their
+ * streaming decoder (img_rle.h): a decoded copy of the 480x480 splash alone would take 450 KB.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "img_cache.h"
+#include "mem_place.h"
+#include "metrics.h"
+#include "ui_bench.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PRELOAD_PERIOD  20      // ms between two preloaded images
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const void * src;       // NULL if the entry is free
+    uint8_t * buf;          // Decoded pixels, as described by the header from info_cb()
+    uint32_t size;
+    uint32_t last_use;      // Value of `use_clock` when the image was last opened
+} entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t get_decoded_size(const void * src, lv_img_header_t * header);
+static lv_res_t info_cb(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t open_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static void close_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static entry_t * find_entry(const void * src);
+static entry_t * load(const void * src);
+static bool decode(const void * src, uint8_t * buf, uint32_t stride);
+static void evict(entry_t * entry);
+static void preload_timer_cb(lv_timer_t * timer);
+static void init_metrics(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static entry_t entries[IMG_CACHE_MAX_ENTRIES];
+static uint32_t resident;           // Bytes held by all entries
+static uint32_t use_clock;
+static bool decoding;               // Let the other decoders open the image being cached
+
+static const void * preload_queue[IMG_CACHE_PRELOAD_MAX];
+static uint8_t preload_cnt;
+static lv_timer_t * preload_timer;
+
+static uint32_t * metric_hits;
+static uint32_t * metric_misses;
+static uint32_t * metric_evictions;
+static uint32_t * metric_preloads;
+static uint32_t * metric_decode_us;
+static uint32_t * metric_decode_max_us;
+static uint32_t * metric_resident;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get what an image takes decoded
+ * @param src image source
+ * @param header store the header of the decoded image here
+ * @return size in bytes, 0 if the image isn't cached
+ */
+static uint32_t get_decoded_size(const void * src, lv_img_header_t * header)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return 0;
+    const lv_img_dsc_t * img = src;
+    lv_img_cf_t cf = img->header.cf;
+
+    // True color and alpha images are drawn from their data or colored on each draw,
+    // compressed ones are streamed row by row without a full copy in RAM
+    bool indexed = cf >= LV_IMG_CF_INDEXED_1BIT && cf <= LV_IMG_CF_INDEXED_8BIT;
+    if (!indexed) return 0;
+
+    // The format the other decoders return rows in
+    bool alpha = lv_img_cf_has_alpha(cf);
+    uint32_t px_size = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t size = (uint32_t)img->header.w * img->header.h * px_size;
+    if (size == 0 || size > IMG_CACHE_SIZE) return 0;
+
+    *header = img->header;
+    header->cf = alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    return size;
+}
+
+static lv_res_t info_cb(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+
+    if (decoding) return LV_RES_INV;
+    return get_decoded_size(src, header) > 0 ? LV_RES_OK : LV_RES_INV;
+}
+
+static lv_res_t open_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    entry_t * entry = find_entry(dsc->src);
+    if (entry != NULL) {
+        (*metric_hits)++;
+    }
+    else {
+        (*metric_misses)++;
+        entry = load(dsc->src);
+        // LVGL goes on with the next decoder, which draws the image line by line
+        if (entry == NULL) return LV_RES_INV;
+    }
+
+    entry->last_use = ++use_clock;
+    dsc->img_data = entry->buf;
+    return LV_RES_OK;
+}
+
+static void close_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    LV_UNUSED(dsc);
+    // The decoded image stays in the cache
+}
+
+static entry_t * find_entry(const void * src)
+{
+    for (uint8_t i = 0; i < IMG_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].src == src) return &entries[i];
+    }
+    return NULL;
+}
+
+/**
+ * Decode an image into a new entry, evicting the least recently used ones to make room
+ * @return the entry, NULL if the image isn't cached or couldn't be decoded
+ */
+static entry_t * load(const void * src)
+{
+    lv_img_header_t header;
+    uint32_t size = get_decoded_size(src, &header);
+    if (size == 0) return NULL;
+
+    entry_t * free_entry = find_entry(NULL);
+    while (free_entry == NULL || resident + size > IMG_CACHE_SIZE) {
+        entry_t * lru = NULL;
+        for (uint8_t i = 0; i < IMG_CACHE_MAX_ENTRIES; i++) {
+            if (entries[i].src != NULL && (lru == NULL || entries[i].last_use < lru->last_use)) lru = &entries[i];
+        }
+        if (lru == NULL) return NULL;
+        evict(lru);
+        (*metric_evictions)++;
+        free_entry = lru;
+    }
+
+    uint8_t * buf = mem_place_alloc(size, MEM_PLACE_COLD);
+    if (buf == NULL) return NULL;
+
+    uint32_t start = ui_bench_time_us();
+    bool ok = decode(src, buf, size / header.h);
+    uint32_t decode_us = ui_bench_time_us() - start;
+    *metric_decode_us += decode_us;
+    *metric_decode_max_us = LV_MAX(*metric_decode_max_us, decode_us);
+    if (!ok) {
+        mem_place_free(buf);
+        return NULL;
+    }
+
+    free_entry->src = src;
+    free_entry->buf = buf;
+    free_entry->size = size;
+    free_entry->last_use = ++use_clock;
+    resident += size;
+    *metric_resident = resident;
+    return free_entry;
+}
+
+/**
+ * Decode an image with the other decoders, row by row
+ * @param stride bytes of a decoded row
+ */
+static bool decode(const void * src, uint8_t * buf, uint32_t stride)
+{
+    lv_img_decoder_dsc_t dsc;
+    decoding = true;
+    lv_res_t res = lv_img_decoder_open(&dsc, src, lv_color_black(), 0);
+    decoding = false;
+    if (res != LV_RES_OK) return false;
+
+    // Only indexed images are cached, they are read line by line, see get_decoded_size()
+    bool ok = dsc.img_data == NULL;
+    for (lv_coord_t y = 0; ok && y < dsc.header.h; y++) {
+        ok = lv_img_decoder_read_line(&dsc, 0, y, dsc.header.w, buf + (uint32_t)y * stride) == LV_RES_OK;
+    }
+    lv_img_decoder_close(&dsc);
+    return ok;
+}
+
+static void evict(entry_t * entry)
+{
+    mem_place_free(entry->buf);
+    resident -= entry->size;
+    *metric_resident = resident;
+    entry->src = NULL;
+    entry->buf = NULL;
+    entry->size = 0;
+}
+
+static void preload_timer_cb(lv_timer_t * timer)
+{
+    if (preload_cnt == 0) {
+        lv_timer_pause(timer);
+        return;
+    }
+
+    const void * src = preload_queue[0];
+    preload_cnt--;
+    memmove(preload_queue, &preload_queue[1], preload_cnt * sizeof(preload_queue[0]));
+
+    if (find_entry(src) == NULL && load(src) != NULL) {
+        (*metric_preloads)++;
+    }
+}
+
+static void init_metrics(void)
+{
+    metric_hits = metrics_get("img_cache.hits");
+    metric_misses = metrics_get("img_cache.misses");
+    metric_evictions = metrics_get("img_cache.evictions");
+    metric_preloads = metrics_get("img_cache.preloads");
+    metric_decode_us = metrics_get("img_cache.decode_us");
+    metric_decode_max_us = metrics_get("img_cache.decode_max_us");
+    metric_resident = metrics_get("img_cache.resident");
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void img_cache_init(void)
+{
+    init_metrics();
+
+    // Decoders created later are asked first
+    lv_img_decoder_t * decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, info_cb);
+    lv_img_decoder_set_open_cb(decoder, open_cb);
+    lv_img_decoder_set_close_cb(decoder, close_cb);
+
+    preload_timer = lv_timer_create(preload_timer_cb, PRELOAD_PERIOD, NULL);
+    lv_timer_pause(preload_timer);
+}
+
+void img_cache_preload(const void * src)
+{
+    lv_img_header_t header;
+    if (preload_cnt == IMG_CACHE_PRELOAD_MAX || get_decoded_size(src, &header) == 0) return;
+
+    preload_queue[preload_cnt++] = src;
+    lv_timer_resume(preload_timer);
+    lv_timer_ready(preload_timer);
+}
+
+void img_cache_invalidate_src(const void * src)
+{
+    for (uint8_t i = 0; i < IMG_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].src != NULL && (src == NULL || entries[i].src == src)) evict(&entries[i]);
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file img_cache.h
+ * Cache of decoded images in place of LVGL's image cache. Indexed images, which LVGL would convert
+ * line by line on every draw, are decoded once as a whole and kept in PSRAM, the least recently used
+ * are evicted to stay within IMG_CACHE_SIZE bytes. Assets can be decoded ahead of time between frames,
+ * so showing them never decodes while rendering. Compressed IMG_RLE_CF images are left to their
+ * streaming decoder (img_rle.h): a decoded copy of the 480x480 splash alone would take 450 KB.
+ */
+
+#ifndef IMG_CACHE_H
+#define IMG_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef IMG_CACHE_SIZE
+#define IMG_CACHE_SIZE          (1024U * 1024U)     // Bytes of decoded images kept, larger images aren't cached
+#endif
+#ifndef IMG_CACHE_MAX_ENTRIES
+#define IMG_CACHE_MAX_ENTRIES   8
+#endif
+#ifndef IMG_CACHE_PRELOAD_MAX
+#define IMG_CACHE_PRELOAD_MAX   8                   // Images waiting to be preloaded
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Register the cache as image decoder. Call it after lv_init() and img_rle_init(), it has to come
+ * before LVGL's built-in decoder in LVGL's list.
+ */
+void img_cache_init(void);
+
+/**
+ * Decode an image between frames, one image per LVGL timer run, usually before the next refresh.
+ * Images the cache doesn't take, e.g. true color ones drawn straight from flash or compressed ones,
+ * are skipped.
+ * @param src an image descriptor (lv_img_dsc_t)
+ */
+void img_cache_preload(const void * src);
+
+/**
+ * Free the decoded data of an image, e.g. once it won't be shown again or its data changed
+ * @param src an image descriptor, NULL to empty the cache
+ */
+void img_cache_invalidate_src(const void * src);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*IMG_CACHE_H*/
@@ -0,0 +1,171 @@
+/**
+ * @file img_rle.c
+ * Image decoder for indexed images compressed at build time by scripts/compress-images.py.
+ * Rows are unpacked on demand into LVGL's line buffer, the image is never decoded as a whole.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <string.h>
+#include "img_rle.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const uint16_t * row_offset;
+    const uint8_t * stream;
+    uint32_t stream_size;
+    lv_coord_t row_y;           // Row held in `row`, -1 if none
+    uint16_t stride;            // Bytes of an unpacked row
+    uint8_t bpp;
+    lv_color_t palette[256];    // Only the first `1 << bpp` are allocated
+} decoder_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const lv_img_dsc_t * get_img(const void * src);
+static lv_res_t info_cb(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t open_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                             lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
+static void close_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static bool unpack_row(const decoder_ctx_t * ctx, lv_coord_t y, uint8_t * row);
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static const lv_img_dsc_t * get_img(const void * src)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return NULL;
+    const lv_img_dsc_t * img = src;
+    return img->header.cf == IMG_RLE_CF ? img : NULL;
+}
+
+static lv_res_t info_cb(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+
+    const lv_img_dsc_t * img = get_img(src);
+    if (img == NULL) return LV_RES_INV;
+
+    *header = img->header;
+    return LV_RES_OK;
+}
+
+static lv_res_t open_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    const lv_img_dsc_t * img = get_img(dsc->src);
+    if (img == NULL) return LV_RES_INV;
+
+    const img_rle_header_t * hdr = (const img_rle_header_t *)img->data;
+    uint8_t bpp = hdr->bpp;
+    if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) return LV_RES_INV;
+
+    uint32_t colors = 1U << bpp;
+    uint32_t tables = sizeof(img_rle_header_t) + colors * sizeof(lv_color32_t) + img->header.h * sizeof(uint16_t);
+    if (tables + hdr->stream_size > img->data_size) return LV_RES_INV;
+
+    // The palette is cut to the colors used, followed by the buffer of one unpacked row
+    uint16_t stride = (uint16_t)((img->header.w * bpp + 7) / 8);
+    size_t ctx_size = offsetof(decoder_ctx_t, palette) + colors * sizeof(lv_color_t);
+    decoder_ctx_t * ctx = lv_mem_alloc(ctx_size + stride);
+    if (ctx == NULL) return LV_RES_INV;
+
+    const lv_color32_t * palette = (const lv_color32_t *)(img->data + sizeof(img_rle_header_t));
+    for (uint32_t i = 0; i < colors; i++) {
+        ctx->palette[i] = lv_color_make(palette[i].ch.red, palette[i].ch.green, palette[i].ch.blue);
+    }
+    ctx->row_offset = (const uint16_t *)(palette + colors);
+    ctx->stream = img->data + tables;
+    ctx->stream_size = hdr->stream_size;
+    ctx->row_y = -1;
+    ctx->stride = stride;
+    ctx->bpp = bpp;
+
+    // No decoded image, LVGL asks for the rows with read_line_cb()
+    dsc->img_data = NULL;
+    dsc->user_data = ctx;
+    return LV_RES_OK;
+}
+
+static bool unpack_row(const decoder_ctx_t * ctx, lv_coord_t y, uint8_t * row)
+{
+    const uint8_t * in = ctx->stream + ctx->row_offset[y];
+    const uint8_t * end = ctx->stream + ctx->stream_size;
+    uint32_t n = 0;
+
+    while (n < ctx->stride && in < end) {
+        uint8_t h = *in++;
+        uint32_t count;
+        if (h < 128) {
+            count = h + 1U;
+            if (count > ctx->stride - n || count > (uint32_t)(end - in)) return false;
+            memcpy(row + n, in, count);
+            in += count;
+        }
+        else if (h > 128) {
+            count = 257U - h;
+            if (count > ctx->stride - n || in == end) return false;
+            memset(row + n, *in++, count);
+        }
+        else {
+            continue;   // No-op byte of PackBits
+        }
+        n += count;
+    }
+    return n == ctx->stride;
+}
+
+static lv_res_t read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                             lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+
+    decoder_ctx_t * ctx = dsc->user_data;
+    uint8_t * row = (uint8_t *)&ctx->palette[1U << ctx->bpp];
+
+    // The same row is read again for each draw area it crosses
+    if (ctx->row_y != y) {
+        ctx->row_y = -1;
+        if (!unpack_row(ctx, y, row)) return LV_RES_INV;
+        ctx->row_y = y;
+    }
+
+    lv_color_t * out = (lv_color_t *)buf;
+    uint8_t bpp = ctx->bpp;
+    uint8_t mask = (uint8_t)((1U << bpp) - 1);
+    for (lv_coord_t i = 0; i < len; i++) {
+        uint32_t bit = (uint32_t)(x + i) * bpp;
+        uint8_t shift = (uint8_t)(8 - bpp - (bit & 7));   // Leftmost pixel in the top bits
+        out[i] = ctx->palette[(row[bit >> 3] >> shift) & mask];
+    }
+    return LV_RES_OK;
+}
+
+static void close_cb(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    lv_mem_free(dsc->user_data);
+    dsc->user_data = NULL;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void img_rle_init(void)
+{
+    lv_img_decoder_t * decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, info_cb);
+    lv_img_decoder_set_open_cb(decoder, open_cb);
+    lv_img_decoder_set_read_line_cb(decoder, read_line_cb);
+    lv_img_decoder_set_close_cb(decoder, close_cb);
+}
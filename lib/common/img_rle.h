@@ -0,0 +1,55 @@
+/**
+ * @file img_rle.h
+ * Image decoder for indexed images compressed at build time by scripts/compress-images.py.
+ * Rows are unpacked on demand into LVGL's line buffer, the image is never decoded as a whole.
+ */
+
+#ifndef IMG_RLE_H
+#define IMG_RLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMG_RLE_CF  LV_IMG_CF_USER_ENCODED_0    // Color format of the compressed images
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Start of the data of an IMG_RLE_CF image, followed by
+ * - the palette: `1 << bpp` opaque lv_color32_t
+ * - the row offsets: `h` uint16_t, where each row starts in the stream
+ * - the stream: each row of the index bitmap, packed like LV_IMG_CF_INDEXED_xBIT and PackBits
+ *   encoded on its own: a byte n < 128 is followed by n + 1 literal bytes, n > 128 by one byte
+ *   repeated 257 - n times
+ */
+typedef struct {
+    uint8_t bpp;            // Bits per index: 1, 2, 4 or 8
+    uint8_t reserved[3];
+    uint32_t stream_size;
+} img_rle_header_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Register the decoder, call it after lv_init() and before an IMG_RLE_CF image is drawn
+ */
+void img_rle_init(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*IMG_RLE_H*/
@@ -0,0 +1,82 @@
+/**
+ * @file interp.c
+ * Fixed-point interpolation of a value between sparse samples over the measured sample interval
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "interp.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FRAC_SHIFT  16      // Progress of a move in 1/65536 units
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void interp_push(interp_t * interp, int32_t value, uint32_t now_ms, uint16_t smoothing)
+{
+    if (!interp->has_sample) {
+        interp_set(interp, value);
+        interp->start_ms = now_ms;
+        return;
+    }
+
+    // Moving average of the sample interval, a long gap starts over
+    uint32_t elapsed = now_ms - interp->start_ms;
+    if (elapsed > INTERP_MAX_INTERVAL) {
+        interp->interval_ms = 0;
+    } else if (elapsed >= INTERP_MIN_INTERVAL) {
+        interp->interval_ms = interp->interval_ms == 0 ? elapsed : (3 * interp->interval_ms + elapsed) / 4;
+    }
+
+    if (smoothing > INTERP_SMOOTHING_MAX) smoothing = INTERP_SMOOTHING_MAX;
+
+    // Continue from the shown value, so a sample arriving mid-move doesn't jump
+    interp->from = interp->shown;
+    interp->to = value;
+    interp->start_ms = now_ms;
+    interp->duration_ms = interp->interval_ms * smoothing / 100;
+    interp->moving = interp->from != interp->to;
+
+    if (interp->duration_ms == 0) interp_set(interp, value);
+}
+
+void interp_set(interp_t * interp, int32_t value)
+{
+    interp->from = value;
+    interp->to = value;
+    interp->shown = value;
+    interp->has_sample = true;
+    interp->moving = false;
+}
+
+bool interp_step(interp_t * interp, uint32_t now_ms)
+{
+    if (!interp->moving) return false;
+
+    int32_t prev = interp->shown;
+    uint32_t elapsed = now_ms - interp->start_ms;
+    if (elapsed >= interp->duration_ms) {
+        interp->shown = interp->to;
+        interp->moving = false;
+    } else {
+        uint32_t frac = (uint32_t)(((uint64_t)elapsed << FRAC_SHIFT) / interp->duration_ms);
+        int64_t delta = (int64_t)interp->to - interp->from;
+        interp->shown = interp->from + (int32_t)((delta * frac) >> FRAC_SHIFT);
+    }
+    return interp->shown != prev;
+}
+
+bool interp_is_moving(const interp_t * interp)
+{
+    return interp->moving;
+}
+
+int32_t interp_get(const interp_t * interp)
+{
+    return interp->shown;
+}
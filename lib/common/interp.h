@@ -0,0 +1,87 @@
+/**
+ * @file interp.h
+ * Fixed-point interpolation of a value between sparse samples over the measured sample interval
+ */
+
+#ifndef INTERP_H
+#define INTERP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define INTERP_SMOOTHING_DEFAULT    100     // % of the sample interval a change takes
+#define INTERP_SMOOTHING_MAX        400
+#define INTERP_MIN_INTERVAL         10      // ms, shorter intervals are measurement noise
+#define INTERP_MAX_INTERVAL         1000    // ms, a longer gap starts over without interpolating
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int32_t from;           // Shown value when the latest sample arrived
+    int32_t to;             // Latest sample
+    int32_t shown;
+    uint32_t start_ms;      // Arrival of the latest sample
+    uint32_t duration_ms;   // Time to move from `from` to `to`
+    uint32_t interval_ms;   // Smoothed time between samples, 0 until measured
+    bool has_sample;
+    bool moving;
+} interp_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Add a sample. The shown value moves from where it is to the sample within
+ * `smoothing` % of the measured sample interval: 0 shows samples right away, 100 arrives
+ * when the next sample is due, more trades latency for a smoother, slower motion.
+ * @param interp pointer to an interpolator, zero initialized before the first use
+ * @param value the sample
+ * @param now_ms current time
+ * @param smoothing 0 .. INTERP_SMOOTHING_MAX
+ */
+void interp_push(interp_t * interp, int32_t value, uint32_t now_ms, uint16_t smoothing);
+
+/**
+ * Show a value right away, e.g. after a page that didn't follow the samples is shown again
+ * @param interp pointer to an interpolator
+ * @param value the value
+ */
+void interp_set(interp_t * interp, int32_t value);
+
+/**
+ * Advance the shown value, call it once per frame while interp_is_moving()
+ * @param interp pointer to an interpolator
+ * @param now_ms current time
+ * @return true if the shown value changed
+ */
+bool interp_step(interp_t * interp, uint32_t now_ms);
+
+/**
+ * Check if the shown value still moves towards the latest sample
+ * @param interp pointer to an interpolator
+ */
+bool interp_is_moving(const interp_t * interp);
+
+/**
+ * Get the shown value
+ * @param interp pointer to an interpolator
+ */
+int32_t interp_get(const interp_t * interp);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*INTERP_H*/
@@ -7,14 +7,44 @@
  *      INCLUDES
  *********************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "lv_gaggiuino_ui.h"
+#include "ui_model.h"
+#include "ui_bench.h"
+#include "shot_series.h"
+#include "shot_chart.h"
+#include "gauge.h"
+#include "readout.h"
+#include "metrics.h"
+#include "vlist.h"
+#include "popup_queue.h"
+#include "interp.h"
+#include "mem_pool.h"
+#include "img_rle.h"
+#include "img_cache.h"
+#include "ui_styles.h"
 #include "lvgl.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define NAV_BAR_HEIGHT 40
-#define SPLASH_DISPLAY_TIME 2000  // 2 seconds
+#define BUILD_BUDGET_US 8000    // Time spent on build steps per frame while the splash is shown
+#define PAGE_IDLE_CHECK_PERIOD 1000
+#define SHOT_SAMPLE_PERIOD 100  // 10 Hz, the telemetry rate of the controller
+#define TEMP_GAUGE_MIN 0
+#define TEMP_GAUGE_MAX 150
+#define TEMP_GAUGE_ZONE_START 88    // Usual brew temperatures
+#define TEMP_GAUGE_ZONE_END 96
+#define PROFILE_COUNT 4         // Profile slots home.qPf1 .. home.qPf4 of the controller
+#define LIST_ROW_HEIGHT 40
+#define UNSTORED_TEXT_MAX 64    // Longest text shown when the model can't store it
+
+// Destroy pages not shown for this many ms, 0 keeps them once built
+#ifndef PAGE_IDLE_TIMEOUT
+#define PAGE_IDLE_TIMEOUT 0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -35,14 +65,52 @@ typedef enum {
     OBJ_PROFILE_2,
     OBJ_PROFILE_3,
     OBJ_PROFILE_4,
+    OBJ_HOME_GAUGE,
+    OBJ_HOME_TEMP,
+    OBJ_BREW_TEMP,
+    OBJ_BREW_PRESSURE,
+    OBJ_BREW_FLOW,
+    OBJ_BREW_WEIGHT,
     OBJ_COUNT
 } obj_id_t;
 
 typedef struct {
     const char* name;
-    lv_obj_t* obj;
+    page_id_t page;     // Page the object lives on, PAGE_COUNT if it's not part of a page
+    lv_obj_t* obj;      // NULL while the page is not built
+    uint8_t decimals;   // Numeric values are sent in 1/10^decimals units
+    bool dirty;         // Updated while the page was hidden, applied when it's shown
+    interp_t interp;    // Shown numeric value, moving towards the latest sample
 } obj_lut_entry_t;
 
+typedef struct {
+    uint32_t used;          // LVGL heap held by the widgets of the page, 0 while it's not built
+    uint32_t peak;          // Highest heap use above the state before building, up to the first render
+    uint32_t largest;       // Largest free block left after the first render
+    uint32_t builds;
+} page_heap_t;
+
+typedef struct {
+    const char * name;      // Nextion page name
+    const char * title;     // Tab title
+    void (*create)(lv_obj_t * parent);
+    lv_obj_t * tab;
+    bool built;
+    uint32_t last_active;   // lv_tick_get() when the page was last shown
+    page_heap_t heap;
+} page_entry_t;
+
+typedef struct {
+    const char * name;
+    void (*run)(void);
+} build_step_t;
+
+typedef struct {
+    const char * name;      // Nextion variable or object
+    shot_channel_t ch;
+    int32_t div;            // The controller sends value * div
+} telemetry_entry_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -53,53 +121,438 @@ static void create_plot_screen(lv_obj_t * parent);
 static void create_clean_screen(lv_obj_t * parent);
 static void create_settings_screen(lv_obj_t * parent);
 static void create_nav_bar(lv_obj_t * parent);
+static void create_popup_window(void);
 static void nav_event_cb(lv_event_t * e);
 static void close_modal_cb(lv_event_t * e);
+static void popup_timer_cb(lv_timer_t * timer);
+static void interp_timer_cb(lv_timer_t * timer);
+static void draw_tag_start_cb(lv_disp_drv_t * drv);
+static void draw_tag_end_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void page_activate(page_id_t id);
+static void page_build(page_id_t id);
+static void page_apply_shadow(page_id_t id);
+static void apply_entry(obj_lut_entry_t * entry);
+static void update_entry_text(obj_lut_entry_t * entry, const char * text);
+static void update_entry_value(obj_lut_entry_t * entry, int32_t value);
+static bool defer_update(obj_lut_entry_t * entry);
+static void page_destroy(page_id_t id);
+static void page_idle_timer_cb(lv_timer_t * timer);
+static void page_show(page_id_t id);
+static void page_build_timer_cb(lv_timer_t * timer);
+static void page_heap_begin(page_id_t id);
+static void page_heap_end(void);
+static void page_heap_drawn_cb(lv_event_t * e);
+static void page_heap_timer_cb(lv_timer_t * timer);
+static void build_tabview(void);
+static void build_tab(void);
+static void build_home_page(void);
+static void build_popup(void);
+static void build_finish(void);
+static void shot_sample_timer_cb(lv_timer_t * timer);
+static void plot_update(void);
+static void plot_event_cb(lv_event_t * e);
+static void telemetry_update(const char * name, int32_t value, int32_t div);
+static bool is_bound_name(const char * name);
+static lv_obj_t * add_readout_row(lv_obj_t * list, const char * caption, const char * unit);
+static lv_obj_t * create_list(lv_obj_t * parent, uint32_t count, vlist_bind_cb_t bind_cb);
+static lv_obj_t * list_row_create_cb(lv_obj_t * list);
+static void profile_bind_cb(lv_obj_t * list, lv_obj_t * row, uint32_t index);
+static void static_text_bind_cb(lv_obj_t * list, lv_obj_t * row, uint32_t index);
+static void set_object_text(lv_obj_t * obj, const char * text);
+static void move_object_text(lv_obj_t * obj, const char * text);
+static void show_unstored_text(const char * object, const char * text);
+static void set_object_value(const obj_lut_entry_t * entry, int32_t value);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static lv_obj_t * tv;  // Tab view for main navigation
+LV_IMG_DECLARE(splash);  // Compressed by scripts/compress-images.py
 static lv_obj_t * splash_screen;
-static lv_timer_t * splash_timer;
+static lv_timer_t * build_timer;
 static lv_obj_t * popup_window;  // Modal window for messages
+static lv_timer_t * popup_timer;  // Renders the transitions of the popup queue, paused while idle
+static lv_timer_t * interp_timer;  // Moves the shown values towards the samples, paused while idle
+static uint16_t smoothing = INTERP_SMOOTHING_DEFAULT;
+static lv_timer_t * page_idle_timer;
+static lv_timer_t * page_build_timer;  // Switches pages and builds them on their first visit, outside of the message handler
+static lv_timer_t * page_heap_timer;  // Ends the heap measurement of a page after its first render
+static page_id_t heap_page = PAGE_COUNT;  // Page whose heap use is being measured
+static uint32_t heap_base;  // Heap use before building `heap_page`
+static uint32_t page_idle_timeout = PAGE_IDLE_TIMEOUT;
+static page_id_t active_page = PAGE_SPLASH;
+static page_id_t requested_page = PAGE_HOME;  // Page asked for while the splash is shown
+static page_id_t shown_page = PAGE_COUNT;     // Page asked for by the controller, shown by page_build_timer
+
+// Pages are built on their first visit, tab index is the page id minus PAGE_HOME
+static page_entry_t pages[PAGE_COUNT] = {
+    [PAGE_SPLASH] = {"splash", NULL, NULL},
+    [PAGE_HOME] = {"home", "Home", create_home_screen},
+    [PAGE_BREW] = {"brew", "Brew", create_brew_screen},
+    [PAGE_PLOT] = {"plot", "Plot", create_plot_screen},
+    [PAGE_CLEAN] = {"clean", "Clean", create_clean_screen},
+    [PAGE_SETTINGS] = {"settings", "Settings", create_settings_screen},
+};
 
 // Object lookup table
 static obj_lut_entry_t obj_lut[] = {
-    [OBJ_POPUP_MSG] = {"popupMSG.t0", NULL},  // Will be initialized when popup is created
-    [OBJ_PROFILE_1] = {"home.qPf1", NULL},
-    [OBJ_PROFILE_2] = {"home.qPf2", NULL},
-    [OBJ_PROFILE_3] = {"home.qPf3", NULL},
-    [OBJ_PROFILE_4] = {"home.qPf4", NULL},
-    [OBJ_COUNT] = {NULL, NULL}  // Terminator entry
+    [OBJ_POPUP_MSG] = {"popupMSG.t0", PAGE_COUNT, NULL},  // Will be initialized when popup is created
+    [OBJ_PROFILE_1] = {"home.qPf1", PAGE_HOME, NULL},
+    [OBJ_PROFILE_2] = {"home.qPf2", PAGE_HOME, NULL},
+    [OBJ_PROFILE_3] = {"home.qPf3", PAGE_HOME, NULL},
+    [OBJ_PROFILE_4] = {"home.qPf4", PAGE_HOME, NULL},
+    // Telemetry readouts, a name may be shown on several pages
+    [OBJ_HOME_GAUGE] = {"currentTemp", PAGE_HOME, NULL, 0},
+    [OBJ_HOME_TEMP] = {"currentTemp", PAGE_HOME, NULL, 0},
+    [OBJ_BREW_TEMP] = {"currentTemp", PAGE_BREW, NULL, 0},
+    [OBJ_BREW_PRESSURE] = {"pressure", PAGE_BREW, NULL, 1},
+    [OBJ_BREW_FLOW] = {"flow", PAGE_BREW, NULL, 1},
+    [OBJ_BREW_WEIGHT] = {"weight", PAGE_BREW, NULL, 1},
+    [OBJ_COUNT] = {NULL, PAGE_COUNT, NULL}  // Terminator entry
 };
 
-static void splash_timer_cb(lv_timer_t * timer)
+// UI construction while the splash is shown, a few steps per frame within BUILD_BUDGET_US
+static const build_step_t build_steps[] = {
+    {"tabview", build_tabview},
+    {"tab home", build_tab},
+    {"tab brew", build_tab},
+    {"tab plot", build_tab},
+    {"tab clean", build_tab},
+    {"tab settings", build_tab},
+    {"page home", build_home_page},
+    {"popup", build_popup},
+};
+static uint8_t build_next;
+static page_id_t build_next_tab = PAGE_HOME;
+static uint32_t build_start_us;
+static uint32_t build_longest_us;
+static const char * build_longest_name;
+static uint32_t tti_ms;
+
+// Telemetry recorded into the shot series
+static const telemetry_entry_t telemetry[] = {
+    {"pressure", SHOT_CH_PRESSURE, 10},
+    {"flow", SHOT_CH_FLOW, 10},
+    {"currentTemp", SHOT_CH_TEMP, 1},
+    {"weight", SHOT_CH_WEIGHT, 1},
+};
+static int16_t telemetry_latest[SHOT_CH_COUNT];
+static bool telemetry_seen;
+static lv_timer_t * shot_sample_timer;
+
+// Plot of the shot series, one bucket per pixel column
+static lv_obj_t * plot_chart;
+
+// Updates of hidden pages, see page_apply_shadow()
+static uint32_t * metric_shadow_direct;
+static uint32_t * metric_shadow_deferred;
+static uint32_t * metric_shadow_coalesced;
+static uint32_t * metric_shadow_applied;
+
+// Names the model doesn't keep, see lv_gaggiuino_update_text()
+static uint32_t * metric_model_unbound;
+static uint32_t * metric_model_failed;
+static char unstored_popup_text[UNSTORED_TEXT_MAX];  // popupMSG.t0 if the model couldn't store it
+static bool popup_text_unstored;
+
+// Driver callbacks chained by the MEM_TAG_DRAW bracket around each refresh
+static void (*prev_render_start_cb)(lv_disp_drv_t *);
+static void (*prev_monitor_cb)(lv_disp_drv_t *, uint32_t, uint32_t);
+static mem_tag_t draw_prev_tag;
+
+/**
+ * Run build steps until the frame's budget is used up, then let LVGL render a frame
+ */
+static void build_timer_cb(lv_timer_t * timer)
 {
-    lv_obj_del(splash_screen);
-    splash_screen = NULL;
-    lv_timer_del(timer);
-    splash_timer = NULL;
+    (void)timer;
+
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_WIDGETS);
+    uint32_t frame_start = ui_bench_time_us();
+    do {
+        uint32_t step_start = ui_bench_time_us();
+        build_steps[build_next].run();
+        uint32_t step_us = ui_bench_time_us() - step_start;
+        if (step_us > build_longest_us) {
+            build_longest_us = step_us;
+            build_longest_name = build_steps[build_next].name;
+        }
+        build_next++;
+    } while (build_next < sizeof(build_steps) / sizeof(build_steps[0]) &&
+             ui_bench_time_us() - frame_start < BUILD_BUDGET_US);
+    mem_pool_set_tag(prev_tag);
+
+    if (build_next == sizeof(build_steps) / sizeof(build_steps[0])) {
+        build_finish();
+    }
+}
 
-    // Create main UI
+static void build_tabview(void)
+{
+    // Hidden until everything is built, the splash stays on top meanwhile
     tv = lv_tabview_create(lv_scr_act(), LV_DIR_TOP, NAV_BAR_HEIGHT);
     lv_obj_set_size(tv, LV_PCT(100), LV_PCT(100));
+    lv_obj_add_flag(tv, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_event_cb(tv, nav_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
 
     // Create navigation bar
     create_nav_bar(tv);
+}
+
+/* Add the next empty tab, pages are built on their first visit */
+static void build_tab(void)
+{
+    pages[build_next_tab].tab = lv_tabview_add_tab(tv, pages[build_next_tab].title);
+    build_next_tab++;
+}
+
+static void build_home_page(void)
+{
+    page_build(PAGE_HOME);
+}
+
+static void build_popup(void)
+{
+    create_popup_window();
+
+    // Messages queued while building are shown from the first frame on
+    popup_timer = lv_timer_create(popup_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+    if (!popup_queue_is_pending()) lv_timer_pause(popup_timer);
+}
+
+/* Swap the splash for the main UI */
+static void build_finish(void)
+{
+    lv_timer_del(build_timer);
+    build_timer = NULL;
+
+    lv_obj_del(splash_screen);
+    splash_screen = NULL;
+    lv_obj_clear_flag(tv, LV_OBJ_FLAG_HIDDEN);
+
+    page_build_timer = lv_timer_create(page_build_timer_cb, 0, NULL);
+    lv_timer_pause(page_build_timer);
+    page_activate(PAGE_HOME);
+    page_idle_timer = lv_timer_create(page_idle_timer_cb, PAGE_IDLE_CHECK_PERIOD, NULL);
+    shot_sample_timer = lv_timer_create(shot_sample_timer_cb, SHOT_SAMPLE_PERIOD, NULL);
+    if (requested_page != PAGE_HOME) {
+        lv_gaggiuino_show_page(pages[requested_page].name);
+    }
+
+    tti_ms = (ui_bench_time_us() - build_start_us) / 1000;
+    printf("UI interactive after %u ms, longest build step: %s (%u us)\n",
+           (unsigned)tti_ms, build_longest_name, (unsigned)build_longest_us);
+}
+
+/**
+ * Called when the active tab changes, by a click on the nav bar or a swipe
+ */
+static void nav_event_cb(lv_event_t * e)
+{
+    lv_obj_t * tabview = lv_event_get_target(e);
+    page_id_t id = (page_id_t)(PAGE_HOME + lv_tabview_get_tab_act(tabview));
+
+    page_activate(id);
+}
+
+/**
+ * Make a page the active one: build it on its first visit, or apply the updates
+ * it missed while it was hidden
+ */
+static void page_activate(page_id_t id)
+{
+    pages[active_page].last_active = lv_tick_get();
+    active_page = id;
+
+    if (!pages[id].built) {
+        // Building allocates the widgets and their buffers, keep that out of the protocol loop.
+        // The timer runs before the next refresh.
+        lv_timer_resume(page_build_timer);
+        lv_timer_ready(page_build_timer);
+        return;
+    }
+
+    page_apply_shadow(id);
+
+    // The plot catches up with the samples recorded while it was hidden
+    if (id == PAGE_PLOT) plot_update();
+}
+
+/**
+ * Switch to a page asked for by the controller
+ */
+static void page_show(page_id_t id)
+{
+    // The controller switches to the brew page when a shot starts
+    if (id == PAGE_BREW && active_page != PAGE_BREW) {
+        shot_series_reset();
+        plot_update();
+    }
+
+    // lv_tabview_set_act() doesn't send LV_EVENT_VALUE_CHANGED
+    page_activate(id);
+    lv_tabview_set_act(tv, id - PAGE_HOME, LV_ANIM_ON);
+}
+
+static void page_build_timer_cb(lv_timer_t * timer)
+{
+    if (shown_page != PAGE_COUNT) {
+        page_show(shown_page);
+        shown_page = PAGE_COUNT;
+    }
+
+    // Paused after page_show(), which resumes the timer for a page that isn't built
+    lv_timer_pause(timer);
+    if (pages[active_page].built) return;
+
+    page_build(active_page);
+    if (active_page == PAGE_PLOT) plot_update();
+}
+
+/**
+ * Create the widgets of a page and fill them from the model
+ */
+static void page_build(page_id_t id)
+{
+    page_entry_t * page = &pages[id];
+    if (page->built || page->create == NULL) return;
+
+    page_heap_begin(id);
 
-    // Create pages
-    lv_obj_t *t1 = lv_tabview_add_tab(tv, "Home");
-    lv_obj_t *t2 = lv_tabview_add_tab(tv, "Brew");
-    lv_obj_t *t3 = lv_tabview_add_tab(tv, "Plot");
-    lv_obj_t *t4 = lv_tabview_add_tab(tv, "Clean");
-    lv_obj_t *t5 = lv_tabview_add_tab(tv, "Settings");
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_WIDGETS);
+    page->create(page->tab);
+    page->built = true;
 
-    create_home_screen(t1);
-    create_brew_screen(t2);
-    create_plot_screen(t3);
-    create_clean_screen(t4);
-    create_settings_screen(t5);
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (obj_lut[i].page == id && obj_lut[i].obj != NULL) apply_entry(&obj_lut[i]);
+    }
+    mem_pool_set_tag(prev_tag);
+
+    mem_pool_stats_t stats;
+    mem_pool_get_stats(&stats);
+    page->heap.used = stats.used > heap_base ? stats.used - heap_base : 0;
+}
+
+/**
+ * Start measuring the heap taken by building and first rendering a page.
+ * lv_mem_monitor() knows nothing about the custom heap, mem_pool is asked instead.
+ */
+static void page_heap_begin(page_id_t id)
+{
+    page_entry_t * page = &pages[id];
+
+    // A page built before the previous one was rendered ends that measurement early
+    if (heap_page != PAGE_COUNT) page_heap_end();
+
+    if (page_heap_timer == NULL) {
+        page_heap_timer = lv_timer_create(page_heap_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+        lv_timer_pause(page_heap_timer);
+    }
+    // Tabs outlive their widgets, so a rebuilt page keeps its callback
+    if (page->heap.builds == 0) lv_obj_add_event_cb(page->tab, page_heap_drawn_cb, LV_EVENT_DRAW_POST_END, NULL);
+    page->heap.builds++;
+
+    mem_pool_stats_t stats;
+    mem_pool_get_stats(&stats);
+    heap_base = stats.used;
+    mem_pool_reset_window_peak();
+    heap_page = id;
+}
+
+static void page_heap_end(void)
+{
+    page_heap_t * heap = &pages[heap_page].heap;
+
+    mem_pool_stats_t stats;
+    mem_pool_get_stats(&stats);
+    heap->peak = LV_MAX(heap->peak, stats.window_peak - heap_base);
+    heap->largest = stats.arena_largest;
+
+    heap_page = PAGE_COUNT;
+    lv_timer_pause(page_heap_timer);
+}
+
+/* The tab of the measured page was drawn, end the measurement once the whole frame is done */
+static void page_heap_drawn_cb(lv_event_t * e)
+{
+    if (heap_page == PAGE_COUNT || lv_event_get_target(e) != pages[heap_page].tab) return;
+
+    lv_timer_resume(page_heap_timer);
+    lv_timer_ready(page_heap_timer);
+}
+
+static void page_heap_timer_cb(lv_timer_t * timer)
+{
+    (void)timer;
+
+    if (heap_page != PAGE_COUNT) page_heap_end();
+}
+
+/**
+ * Apply the updates recorded while a page was hidden in one batch, the model
+ * holds the latest value of each object
+ */
+static void page_apply_shadow(page_id_t id)
+{
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (obj_lut[i].page == id && obj_lut[i].dirty && obj_lut[i].obj != NULL) {
+            apply_entry(&obj_lut[i]);
+            (*metric_shadow_applied)++;
+        }
+    }
+}
+
+/**
+ * Show the stored text or value of an object
+ */
+static void apply_entry(obj_lut_entry_t * entry)
+{
+    const char * text = ui_model_get_text(entry->name);
+    int32_t value;
+    if (text != NULL) {
+        set_object_text(entry->obj, text);
+    } else if (ui_model_get_value(entry->name, &value)) {
+        // The samples received while hidden weren't followed, start from the latest one
+        interp_set(&entry->interp, value);
+        set_object_value(entry, value);
+    }
+    entry->dirty = false;
+}
+
+/**
+ * Delete the widgets of a page, its tab stays. The state lives on in the model.
+ */
+static void page_destroy(page_id_t id)
+{
+    page_entry_t * page = &pages[id];
+    if (!page->built) return;
+
+    if (heap_page == id) page_heap_end();
+    page->heap.used = 0;
+
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (obj_lut[i].page == id) {
+            obj_lut[i].obj = NULL;
+            obj_lut[i].dirty = false;
+        }
+    }
+    lv_obj_clean(page->tab);
+    page->built = false;
+}
+
+static void page_idle_timer_cb(lv_timer_t * timer)
+{
+    (void)timer;
+
+    uint32_t now = lv_tick_get();
+    pages[active_page].last_active = now;
+    if (page_idle_timeout == 0) return;
+
+    for (int i = PAGE_HOME; i < PAGE_COUNT; i++) {
+        if ((page_id_t)i != active_page && pages[i].built && now - pages[i].last_active >= page_idle_timeout) {
+            page_destroy((page_id_t)i);
+        }
+    }
 }
 
 /**********************
@@ -109,7 +562,6 @@ static void splash_timer_cb(lv_timer_t * timer)
 static void create_splash_screen(lv_obj_t * parent)
 {
     // Create logo image
-    LV_IMG_DECLARE(splash);  // You'll need to add this image
     lv_obj_t * logo = lv_img_create(parent);
     lv_img_set_src(logo, &splash);
     lv_obj_center(logo);
@@ -123,26 +575,36 @@ static void create_splash_screen(lv_obj_t * parent)
 static void create_nav_bar(lv_obj_t * parent)
 {
     lv_obj_t * tab_btns = lv_tabview_get_tab_btns(parent);
-    lv_obj_set_style_border_width(tab_btns, 0, 0);
+    ui_styles_add(tab_btns, UI_STYLE_NO_BORDER, 0);
 }
 
 static void create_home_screen(lv_obj_t * parent)
 {
-    // Create temperature gauge
-    lv_obj_t * gauge = lv_meter_create(parent);
+    // Create temperature gauge, the dial is rendered once and only the needle follows the value
+    lv_obj_t * gauge = gauge_create(parent);
     lv_obj_set_size(gauge, 200, 200);
     lv_obj_center(gauge);
+    gauge_set_range(gauge, TEMP_GAUGE_MIN, TEMP_GAUGE_MAX);
+    gauge_set_zone(gauge, TEMP_GAUGE_ZONE_START, TEMP_GAUGE_ZONE_END, lv_palette_main(LV_PALETTE_GREEN));
+    ui_styles_add(gauge, UI_STYLE_GAUGE_NEEDLE, LV_PART_INDICATOR);
+    obj_lut[OBJ_HOME_GAUGE].obj = gauge;
 
-    // Create profile list
-    lv_obj_t * list = lv_list_create(parent);
-    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_pad_all(list, 10, 0);
+    // Large readout fonts have their digits and units in the glyph atlas
+    lv_obj_t * temp_readout = readout_create(gauge);
+    ui_styles_add(temp_readout, UI_STYLE_READOUT_LARGE, 0);
+    readout_set_cells(temp_readout, 3);
+    readout_set_unit(temp_readout, "\xc2\xb0" "C");
+    lv_obj_align(temp_readout, LV_ALIGN_BOTTOM_MID, 0, -20);
+    obj_lut[OBJ_HOME_TEMP].obj = temp_readout;
 
-    // Add some example profiles + add to obj_lut
-    obj_lut[OBJ_PROFILE_1].obj = lv_list_add_text(list, "Profile 1");
-    obj_lut[OBJ_PROFILE_2].obj = lv_list_add_text(list, "Profile 2");
-    obj_lut[OBJ_PROFILE_3].obj = lv_list_add_text(list, "Profile 3");
-    obj_lut[OBJ_PROFILE_4].obj = lv_list_add_text(list, "Profile 4");
+    // Create profile list, the rows are bound to the profiles on scroll
+    lv_obj_t * list = create_list(parent, PROFILE_COUNT, profile_bind_cb);
+    ui_styles_add(list, UI_STYLE_LIST, 0);
+
+    obj_lut[OBJ_PROFILE_1].obj = list;
+    obj_lut[OBJ_PROFILE_2].obj = list;
+    obj_lut[OBJ_PROFILE_3].obj = list;
+    obj_lut[OBJ_PROFILE_4].obj = list;
 }
 
 static void create_brew_screen(lv_obj_t * parent)
@@ -150,27 +612,114 @@ static void create_brew_screen(lv_obj_t * parent)
     // Create brew settings list
     lv_obj_t * list = lv_list_create(parent);
     lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_pad_all(list, 10, 0);
+    ui_styles_add(list, UI_STYLE_LIST, 0);
 
-    // Add brew settings
-    lv_list_add_text(list, "Temperature");
-    lv_list_add_text(list, "Pressure");
-    lv_list_add_text(list, "Flow Rate");
+    // Add brew settings with their live values
+    obj_lut[OBJ_BREW_TEMP].obj = add_readout_row(list, "Temperature", "\xc2\xb0" "C");
+    obj_lut[OBJ_BREW_PRESSURE].obj = add_readout_row(list, "Pressure", "bar");
+    obj_lut[OBJ_BREW_FLOW].obj = add_readout_row(list, "Flow Rate", "ml/s");
+    obj_lut[OBJ_BREW_WEIGHT].obj = add_readout_row(list, "Weight", "g");
     lv_list_add_text(list, "Shot Time");
 }
 
+/**
+ * Add a list row with a caption and a readout on its right
+ * @return the readout
+ */
+static lv_obj_t * add_readout_row(lv_obj_t * list, const char * caption, const char * unit)
+{
+    lv_obj_t * row = lv_list_add_btn(list, NULL, caption);
+    lv_obj_t * readout = readout_create(row);
+    ui_styles_add(readout, UI_STYLE_READOUT, 0);
+    readout_set_unit(readout, unit);
+    return readout;
+}
+
 static void create_plot_screen(lv_obj_t * parent)
 {
-    // Create chart
-    lv_obj_t * chart = lv_chart_create(parent);
+    // Create chart, values are in 1/SHOT_SERIES_SCALE units
+    lv_obj_t * chart = shot_chart_create(parent);
     lv_obj_set_size(chart, LV_PCT(100), LV_PCT(100));
-    lv_chart_set_point_count(chart, 100);
-    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
-    lv_chart_set_range(chart, LV_CHART_AXIS_SECONDARY_Y, 0, 10);
-    lv_chart_set_div_line_count(chart, 5, 5);
-    lv_chart_set_axis_tick(chart, LV_CHART_AXIS_PRIMARY_X, 10, 5, 5, 2, true, 40);
-    lv_chart_set_axis_tick(chart, LV_CHART_AXIS_PRIMARY_Y, 10, 5, 5, 2, true, 40);
-    lv_chart_set_axis_tick(chart, LV_CHART_AXIS_SECONDARY_Y, 10, 5, 5, 2, true, 40);
+    shot_chart_set_range(chart, SHOT_CHART_AXIS_PRIMARY, 0, 100 * SHOT_SERIES_SCALE);
+    shot_chart_set_range(chart, SHOT_CHART_AXIS_SECONDARY, 0, 10 * SHOT_SERIES_SCALE);
+    lv_obj_add_event_cb(chart, plot_event_cb, LV_EVENT_ALL, NULL);
+
+    // Temperature and weight on the primary axis, pressure and flow on the secondary one
+    shot_chart_set_channel(chart, SHOT_CH_TEMP, lv_palette_main(LV_PALETTE_RED), SHOT_CHART_AXIS_PRIMARY);
+    shot_chart_set_channel(chart, SHOT_CH_WEIGHT, lv_palette_main(LV_PALETTE_AMBER), SHOT_CHART_AXIS_PRIMARY);
+    shot_chart_set_channel(chart, SHOT_CH_PRESSURE, lv_palette_main(LV_PALETTE_BLUE), SHOT_CHART_AXIS_SECONDARY);
+    shot_chart_set_channel(chart, SHOT_CH_FLOW, lv_palette_main(LV_PALETTE_GREEN), SHOT_CHART_AXIS_SECONDARY);
+
+    plot_chart = chart;
+    plot_update();
+}
+
+static void plot_event_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_CLICKED) {
+        // Tap to switch between the whole shot and the latest samples
+        shot_chart_mode_t mode = shot_chart_get_mode(plot_chart);
+        shot_chart_set_mode(plot_chart, mode == SHOT_CHART_MODE_FIT ? SHOT_CHART_MODE_SCROLL : SHOT_CHART_MODE_FIT);
+    }
+    else if (code == LV_EVENT_DELETE) {
+        plot_chart = NULL;
+    }
+}
+
+/**
+ * Draw the samples recorded since the last update
+ */
+static void plot_update(void)
+{
+    // A hidden plot is brought up to date when its page is shown
+    if (plot_chart == NULL || active_page != PAGE_PLOT) return;
+
+    shot_chart_refresh(plot_chart);
+}
+
+/**
+ * Record the latest telemetry into the shot series at a fixed rate
+ */
+static void shot_sample_timer_cb(lv_timer_t * timer)
+{
+    (void)timer;
+
+    if (!telemetry_seen) return;
+
+    shot_series_push(lv_tick_get(), telemetry_latest);
+    plot_update();
+}
+
+/**
+ * Store a telemetry value if `name` is one
+ * @param value the received value multiplied by `div`
+ */
+static void telemetry_update(const char * name, int32_t value, int32_t div)
+{
+    for (size_t i = 0; i < sizeof(telemetry) / sizeof(telemetry[0]); i++) {
+        if (strcmp(telemetry[i].name, name) == 0) {
+            telemetry_latest[telemetry[i].ch] = shot_series_fixed(value, div * telemetry[i].div);
+            telemetry_seen = true;
+            return;
+        }
+    }
+}
+
+/**
+ * Check if a name is shown by a widget or recorded as telemetry. Only these names take a slot
+ * of the model, so names the UI doesn't use can't crowd them out.
+ */
+static bool is_bound_name(const char * name)
+{
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (strcmp(obj_lut[i].name, name) == 0) return true;
+    }
+    for (size_t i = 0; i < sizeof(telemetry) / sizeof(telemetry[0]); i++) {
+        if (strcmp(telemetry[i].name, name) == 0) return true;
+    }
+    return false;
 }
 
 static void create_clean_screen(lv_obj_t * parent)
@@ -180,7 +729,7 @@ static void create_clean_screen(lv_obj_t * parent)
     lv_obj_set_size(cont, LV_PCT(100), LV_PCT(100));
     lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_pad_all(cont, 20, 0);
+    ui_styles_add(cont, UI_STYLE_PANEL, 0);
 
     // Create flush button
     lv_obj_t * flush_btn = lv_btn_create(cont);
@@ -202,21 +751,61 @@ static void create_settings_screen(lv_obj_t * parent)
     lv_obj_set_size(settings_tv, LV_PCT(100), LV_PCT(100));
 
     // Create temperature tab
+    static const char * temp_settings[] = {"PID Settings", "Temperature Offset", "Steam Temperature"};
     lv_obj_t * temp_tab = lv_tabview_add_tab(settings_tv, "Temperature");
-    lv_obj_t * temp_list = lv_list_create(temp_tab);
-    lv_obj_set_size(temp_list, LV_PCT(100), LV_PCT(100));
-    lv_list_add_text(temp_list, "PID Settings");
-    lv_list_add_text(temp_list, "Temperature Offset");
-    lv_list_add_text(temp_list, "Steam Temperature");
+    lv_obj_t * temp_list = create_list(temp_tab, sizeof(temp_settings) / sizeof(temp_settings[0]), static_text_bind_cb);
+    lv_obj_set_user_data(temp_list, (void *)temp_settings);
 
     // Create system tab
+    static const char * sys_settings[] = {"Display Brightness", "Units", "Language", "About"};
     lv_obj_t * sys_tab = lv_tabview_add_tab(settings_tv, "System");
-    lv_obj_t * sys_list = lv_list_create(sys_tab);
-    lv_obj_set_size(sys_list, LV_PCT(100), LV_PCT(100));
-    lv_list_add_text(sys_list, "Display Brightness");
-    lv_list_add_text(sys_list, "Units");
-    lv_list_add_text(sys_list, "Language");
-    lv_list_add_text(sys_list, "About");
+    lv_obj_t * sys_list = create_list(sys_tab, sizeof(sys_settings) / sizeof(sys_settings[0]), static_text_bind_cb);
+    lv_obj_set_user_data(sys_list, (void *)sys_settings);
+}
+
+/**
+ * Create a virtual list of text rows, only the visible rows exist as objects
+ */
+static lv_obj_t * create_list(lv_obj_t * parent, uint32_t count, vlist_bind_cb_t bind_cb)
+{
+    lv_obj_t * list = vlist_create(parent);
+    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
+    vlist_set_row_height(list, LIST_ROW_HEIGHT);
+    vlist_set_source(list, list_row_create_cb, bind_cb);
+    vlist_set_count(list, count);
+    return list;
+}
+
+static lv_obj_t * list_row_create_cb(lv_obj_t * list)
+{
+    return lv_list_add_text(list, "");
+}
+
+/**
+ * Show the name of a profile, as sent by the controller
+ */
+static void profile_bind_cb(lv_obj_t * list, lv_obj_t * row, uint32_t index)
+{
+    (void)list;
+
+    char key[16];
+    char fallback[16];
+    lv_snprintf(key, sizeof(key), "home.qPf%u", (unsigned)(index + 1));
+    const char * text = ui_model_get_text(key);
+    if (text == NULL) {
+        lv_snprintf(fallback, sizeof(fallback), "Profile %u", (unsigned)(index + 1));
+        text = fallback;
+    }
+    if (strcmp(lv_label_get_text(row), text) != 0) lv_label_set_text(row, text);
+}
+
+/**
+ * Show an entry of the string array in the user data of the list
+ */
+static void static_text_bind_cb(lv_obj_t * list, lv_obj_t * row, uint32_t index)
+{
+    const char ** texts = lv_obj_get_user_data(list);
+    lv_label_set_text_static(row, texts[index]);
 }
 
 static void create_popup_window(void) {
@@ -230,13 +819,13 @@ static void create_popup_window(void) {
     // Set up flex layout for popup window
     lv_obj_set_flex_flow(popup_window, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(popup_window, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_pad_row(popup_window, 10, 0);  // Add vertical spacing between elements
+    ui_styles_add(popup_window, UI_STYLE_POPUP, 0);  // Add vertical spacing between elements
 
     // Create the message label
     lv_obj_t * label = lv_label_create(popup_window);
     lv_label_set_text(label, "");
     lv_obj_set_width(label, LV_PCT(100));  // Make label take full width
-    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);  // Center text horizontally
+    ui_styles_add(label, UI_STYLE_TEXT_CENTER, 0);  // Center text horizontally
     obj_lut[OBJ_POPUP_MSG].obj = label;
 
     // Create close button
@@ -255,6 +844,158 @@ static void close_modal_cb(lv_event_t * e) {
     lv_gaggiuino_hide_popup();
 }
 
+/**
+ * Render at most one popup transition per frame. Switching between messages only
+ * changes the label, the window is moved to the foreground when it appears.
+ */
+static void popup_timer_cb(lv_timer_t * timer) {
+    lv_obj_t * label = obj_lut[OBJ_POPUP_MSG].obj;
+
+    switch (popup_queue_next(lv_tick_get())) {
+    case POPUP_QUEUE_SHOW:
+        set_object_text(label, popup_queue_get_text());
+        if (lv_obj_has_flag(popup_window, LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_clear_flag(popup_window, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_move_foreground(popup_window);  // Ensure popup is on top when shown
+        }
+        break;
+    case POPUP_QUEUE_HIDE:
+        lv_obj_add_flag(popup_window, LV_OBJ_FLAG_HIDDEN);
+        break;
+    case POPUP_QUEUE_NONE:
+        break;
+    }
+
+    if (!popup_queue_is_pending()) lv_timer_pause(timer);
+}
+
+/**
+ * Show a text in a label or readout, an unchanged text is not set again.
+ * Labels show the text without a copy, it must stay valid until the next call: the model's and the
+ * popup queue's texts do. Virtual lists bind their rows from the model, which already holds the text.
+ */
+static void set_object_text(lv_obj_t * obj, const char * text) {
+    if (lv_obj_check_type(obj, &readout_class)) {
+        readout_set_text(obj, text);
+    } else if (lv_obj_check_type(obj, &vlist_class)) {
+        vlist_refresh(obj);
+    } else {
+        // The text may have changed in place, the label only sees the same pointer then
+        const char * cur = lv_label_get_text(obj);
+        if (cur == text || strcmp(cur, text) != 0) lv_label_set_text_static(obj, text);
+    }
+}
+
+/**
+ * Show a text whose previous storage was freed. Labels still point at the freed block,
+ * so their text is replaced without being read.
+ */
+static void move_object_text(lv_obj_t * obj, const char * text) {
+    if (lv_obj_check_type(obj, &readout_class) || lv_obj_check_type(obj, &vlist_class)) {
+        set_object_text(obj, text);
+    } else {
+        lv_label_set_text_static(obj, text);
+    }
+}
+
+/**
+ * Show a text the model couldn't store, on every widget of the name right away, also on hidden pages.
+ * Labels get their own copy. Virtual lists bind their rows from the model, they keep the stored text.
+ * @param text terminated copy of the text, at most UNSTORED_TEXT_MAX - 1 characters
+ */
+static void show_unstored_text(const char * object, const char * text) {
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (strcmp(obj_lut[i].name, object) != 0) continue;
+
+        lv_obj_t * obj = obj_lut[i].obj;
+        if (i == OBJ_POPUP_MSG) {
+            // Queued from here when the popup is requested
+            strcpy(unstored_popup_text, text);
+            popup_text_unstored = true;
+        } else if (obj != NULL && lv_obj_check_type(obj, &readout_class)) {
+            readout_set_text(obj, text);
+        } else if (obj != NULL && lv_obj_check_type(obj, &lv_label_class)) {
+            lv_label_set_text(obj, text);
+        }
+    }
+}
+
+/**
+ * Show a numeric value in a readout
+ */
+static void set_object_value(const obj_lut_entry_t * entry, int32_t value) {
+    if (lv_obj_check_type(entry->obj, &readout_class)) {
+        readout_set_value(entry->obj, value, entry->decimals);
+    } else if (lv_obj_check_type(entry->obj, &gauge_class)) {
+        gauge_set_value(entry->obj, value);
+    }
+}
+
+/**
+ * Record an update of an object on a hidden page instead of applying it.
+ * The model holds the latest value, so the entry is only marked.
+ * @return true if the update was deferred
+ */
+static bool defer_update(obj_lut_entry_t * entry) {
+    // Objects outside of the pages, like the popup, are always shown right away
+    if (entry->page == PAGE_COUNT || entry->page == active_page) {
+        (*metric_shadow_direct)++;
+        return false;
+    }
+
+    if (entry->dirty) (*metric_shadow_coalesced)++;
+    entry->dirty = true;
+    (*metric_shadow_deferred)++;
+    return true;
+}
+
+static void update_entry_text(obj_lut_entry_t * entry, const char * text) {
+    if (!defer_update(entry)) set_object_text(entry->obj, text);
+}
+
+static void update_entry_value(obj_lut_entry_t * entry, int32_t value) {
+    if (defer_update(entry)) return;
+
+    interp_push(&entry->interp, value, lv_tick_get(), smoothing);
+    if (interp_is_moving(&entry->interp)) {
+        lv_timer_resume(interp_timer);
+    } else {
+        set_object_value(entry, value);
+    }
+}
+
+/**
+ * Tag the allocations made while a frame is rendered: every screen and layer, masks and
+ * image decoding, up to the monitor callback LVGL calls when the refresh is done
+ */
+static void draw_tag_start_cb(lv_disp_drv_t * drv) {
+    draw_prev_tag = mem_pool_set_tag(MEM_TAG_DRAW);
+    if (prev_render_start_cb) prev_render_start_cb(drv);
+}
+
+static void draw_tag_end_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px) {
+    if (prev_monitor_cb) prev_monitor_cb(drv, time, px);
+    mem_pool_set_tag(draw_prev_tag);
+}
+
+/**
+ * Show the interpolated values once per frame until all reached their latest sample
+ */
+static void interp_timer_cb(lv_timer_t * timer) {
+    uint32_t now = lv_tick_get();
+    bool moving = false;
+
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        obj_lut_entry_t * entry = &obj_lut[i];
+        if (entry->obj == NULL || !interp_is_moving(&entry->interp)) continue;
+
+        if (interp_step(&entry->interp, now)) set_object_value(entry, interp_get(&entry->interp));
+        moving |= interp_is_moving(&entry->interp);
+    }
+
+    if (!moving) lv_timer_pause(timer);
+}
+
 static lv_obj_t * find_object(const char* object) {
     for (int i = 0; obj_lut[i].name != NULL; i++) {
         if (strcmp(obj_lut[i].name, object) == 0) {
@@ -264,6 +1005,15 @@ static lv_obj_t * find_object(const char* object) {
     return NULL;
 }
 
+static int find_page(const char * page) {
+    for (int i = 0; i < PAGE_COUNT; i++) {
+        if (strcmp(pages[i].name, page) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -271,48 +1021,181 @@ static lv_obj_t * find_object(const char* object) {
 void lv_gaggiuino_ui_init(void)
 {
     // Initialize default theme
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_STYLES);
     lv_theme_default_init(NULL, lv_palette_main(LV_PALETTE_BLUE), lv_palette_main(LV_PALETTE_RED), LV_THEME_DEFAULT_DARK, LV_FONT_DEFAULT);
+    mem_pool_set_tag(prev_tag);
+
+    // Attribute the layers and buffers allocated while rendering to drawing
+    lv_disp_drv_t * drv = lv_disp_get_default()->driver;
+    prev_render_start_cb = drv->render_start_cb;
+    prev_monitor_cb = drv->monitor_cb;
+    drv->render_start_cb = draw_tag_start_cb;
+    drv->monitor_cb = draw_tag_end_cb;
+
+    build_start_us = ui_bench_time_us();
+
+    metric_shadow_direct = metrics_get("shadow.direct");
+    metric_shadow_deferred = metrics_get("shadow.deferred");
+    metric_shadow_coalesced = metrics_get("shadow.coalesced");
+    metric_shadow_applied = metrics_get("shadow.applied");
+    metric_model_unbound = metrics_get("model.unbound");
+    metric_model_failed = metrics_get("model.failed");
+
+    interp_timer = lv_timer_create(interp_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+    lv_timer_pause(interp_timer);
+
+    // The splash is compressed at build time and streamed row by row, it's only drawn while building
+    img_rle_init();
+    img_cache_init();
 
     // Create splash screen
     splash_screen = lv_obj_create(lv_scr_act());
     lv_obj_set_size(splash_screen, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_bg_color(splash_screen, lv_color_hex(0xFFFFFF), 0);
+    ui_styles_add(splash_screen, UI_STYLE_SPLASH, 0);
     create_splash_screen(splash_screen);
 
-    // Create popup window
-    create_popup_window();
+    // Build the main UI in steps, one batch per frame, the splash ends when all are done
+    build_timer = lv_timer_create(build_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+}
 
-    // Create timer to switch to main UI
-    splash_timer = lv_timer_create(splash_timer_cb, SPLASH_DISPLAY_TIME, NULL);
+/**
+ * Get the time from lv_gaggiuino_ui_init() until the main UI was shown
+ * @return The time in ms, 0 while the splash is still shown
+ */
+uint32_t lv_gaggiuino_get_tti(void) {
+    return tti_ms;
 }
 
 /**
- * Update the text of an object
+ * Update the text of an object. The text is copied once, into the model; labels show the
+ * model's copy. Names no widget shows are counted in `model.unbound` and dropped. If the model
+ * can't store the text (`model.failed`), a copy of it is shown right away.
  * @param object The object to update
- * @param text The text to update the object with
+ * @param text The text to update the object with, not necessarily terminated
+ * @param len The number of characters
+ */
+void lv_gaggiuino_update_text(const char* object, const char* text, size_t len) {
+    LV_LOG_TRACE("Updating text for object: %s to %.*s", object, (int)len, text);
+
+    if (!is_bound_name(object)) {
+        (*metric_model_unbound)++;
+        return;
+    }
+
+    // An unchanged text isn't copied or shown again
+    const char * prev = ui_model_get_text(object);
+    if (prev != NULL && strlen(prev) == len && memcmp(prev, text, len) == 0) return;
+
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_TEXT);
+    bool stored = ui_model_set_text(object, text, len);
+    mem_pool_set_tag(prev_tag);
+
+    char unstored[UNSTORED_TEXT_MAX];
+    const char * shown = unstored;
+    if (stored) {
+        shown = ui_model_get_text(object);
+        if (strcmp(object, obj_lut[OBJ_POPUP_MSG].name) == 0) popup_text_unstored = false;
+    } else {
+        (*metric_model_failed)++;
+        lv_snprintf(unstored, sizeof(unstored), "%.*s", (int)len, text);
+    }
+
+    // Numeric telemetry sent as text, e.g. weight.txt="36.4"
+    char * end;
+    double num = strtod(shown, &end);
+    if (end != shown) {
+        telemetry_update(object, (int32_t)(num * 10 + (num < 0 ? -0.5 : 0.5)), 10);
+    }
+
+    if (!stored) {
+        show_unstored_text(object, shown);
+        return;
+    }
+
+    // Labels on hidden pages still point at the old storage if it moved, they are updated right away then
+    bool moved = prev != NULL && prev != shown;
+
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        // The popup text is shown through the queue when the popup is requested
+        if (i == OBJ_POPUP_MSG) continue;
+        if (obj_lut[i].obj != NULL && strcmp(obj_lut[i].name, object) == 0) {
+            if (moved) move_object_text(obj_lut[i].obj, shown);
+            else update_entry_text(&obj_lut[i], shown);
+        }
+    }
+}
+
+/**
+ * Update a numeric value, e.g. `pressure.val=90` or `currentTemp=93`.
+ * Names are dropped and values shown right away like texts, see lv_gaggiuino_update_text().
+ * @param name The object or variable name
+ * @param value The value
  */
-void lv_gaggiuino_update_text(const char* object, const char* text) {
-    printf("Updating text for object: %s to %s\n", object, text);
-    lv_obj_t * obj = find_object(object);
-    if (obj != NULL) {
-        lv_label_set_text(obj, text);
+void lv_gaggiuino_update_value(const char* name, int32_t value) {
+    if (!is_bound_name(name)) {
+        (*metric_model_unbound)++;
+        return;
+    }
+
+    bool stored = ui_model_set_value(name, value);
+    if (!stored) (*metric_model_failed)++;
+    telemetry_update(name, value, 1);
+
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (obj_lut[i].obj != NULL && strcmp(obj_lut[i].name, name) == 0) {
+            // A hidden page would be rebuilt or shown from the model, which missed the value
+            if (stored) update_entry_value(&obj_lut[i], value);
+            else set_object_value(&obj_lut[i], value);
+        }
     }
 }
 
 /**
- * Show a modal message window
- * @param message The message to display
+ * Get the Nextion name of an object
+ * @param obj The object to look up
+ * @return The name, e.g. "home.qPf1", or NULL if the object has none
+ */
+const char * lv_gaggiuino_get_object_name(const lv_obj_t * obj) {
+    for (int i = 0; obj_lut[i].name != NULL; i++) {
+        if (obj_lut[i].obj == obj) {
+            return obj_lut[i].name;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Get the page an object stands for
+ * @param obj The object to look up
+ * @return The page name for the tab of a page, the splash screen or the popup window, NULL otherwise
+ */
+const char * lv_gaggiuino_get_page_name(const lv_obj_t * obj) {
+    if (obj == NULL) return NULL;
+    if (obj == splash_screen) return pages[PAGE_SPLASH].name;
+    if (obj == popup_window) return "popupMSG";
+
+    for (int i = PAGE_HOME; i < PAGE_COUNT; i++) {
+        if (pages[i].tab == obj) return pages[i].name;
+    }
+    return NULL;
+}
+
+/**
+ * Queue the current popupMSG.t0 text for the modal message window.
+ * Repeated messages are dropped and bursts coalesced, see popup_queue.h.
  */
 void lv_gaggiuino_show_popup(void) {
-    lv_obj_clear_flag(popup_window, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_move_foreground(popup_window);  // Ensure popup is on top when shown
+    const char * text = popup_text_unstored ? unstored_popup_text : ui_model_get_text(obj_lut[OBJ_POPUP_MSG].name);
+    popup_queue_push(text != NULL ? text : "", lv_tick_get());
+    if (popup_timer != NULL) lv_timer_resume(popup_timer);  // Still building otherwise, the queue keeps the message
 }
 
 /**
- * Hide the modal message window
+ * Close the modal message window, the next queued message is shown instead if there is one
  */
 void lv_gaggiuino_hide_popup(void) {
-    lv_obj_add_flag(popup_window, LV_OBJ_FLAG_HIDDEN);
+    popup_queue_dismiss();
+    if (popup_timer != NULL) lv_timer_resume(popup_timer);
 }
 
 /**
@@ -321,9 +1204,81 @@ void lv_gaggiuino_hide_popup(void) {
  */
 void lv_gaggiuino_show_page(const char *page)
 {
-    // lv_tabview_set_tab_act(tv, page, LV_ANIM_OFF);
     if (strcmp(page, "popupMSG") == 0)
     {
         lv_gaggiuino_show_popup();
+        return;
+    }
+
+    int id = find_page(page);
+    if (id >= PAGE_HOME && build_timer != NULL)
+    {
+        requested_page = (page_id_t)id;
+    }
+    else if (id >= PAGE_HOME && tv != NULL)
+    {
+        // The tab scroll animation allocates, the switch is done by the timer before the next refresh
+        shown_page = (page_id_t)id;
+        lv_timer_resume(page_build_timer);
+        lv_timer_ready(page_build_timer);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Print the LVGL heap taken by each page as `page.<name>.heap.<stat> value` lines
+ */
+void lv_gaggiuino_print_page_heap(void)
+{
+    uint32_t total = 0;
+    for (int i = PAGE_HOME; i < PAGE_COUNT; i++) {
+        const page_heap_t * heap = &pages[i].heap;
+        printf("page.%s.heap.used %u\n", pages[i].name, (unsigned)heap->used);
+        printf("page.%s.heap.peak %u\n", pages[i].name, (unsigned)heap->peak);
+        printf("page.%s.heap.largest_free %u\n", pages[i].name, (unsigned)heap->largest);
+        printf("page.%s.heap.builds %u\n", pages[i].name, (unsigned)heap->builds);
+        total += heap->used;
+    }
+
+    // What all pages would take if they were built at the same time
+    printf("page.heap.used %u/%u\n", (unsigned)total, (unsigned)MEM_POOL_SIZE);
+}
+
+/**
+ * Set how long a page may stay hidden before its widgets are deleted
+ * @param timeout_ms idle time in ms, 0 to keep pages once they are built
+ */
+void lv_gaggiuino_set_page_idle_timeout(uint32_t timeout_ms)
+{
+    page_idle_timeout = timeout_ms;
+}
+
+/**
+ * Get how long a page may stay hidden before its widgets are deleted
+ * @return idle time in ms, 0 if pages are kept once they are built
+ */
+uint32_t lv_gaggiuino_get_page_idle_timeout(void)
+{
+    return page_idle_timeout;
+}
+
+/**
+ * Get how many times pages were built, first builds and rebuilds after an idle timeout
+ */
+uint32_t lv_gaggiuino_get_page_builds(void)
+{
+    uint32_t builds = 0;
+    for (int i = PAGE_HOME; i < PAGE_COUNT; i++) {
+        builds += pages[i].heap.builds;
+    }
+    return builds;
+}
+
+/**
+ * Set how smoothly numeric values move between samples
+ * @param percent time a change takes in % of the measured sample interval, 0 shows samples
+ *                right away, higher values are smoother but lag more (at most INTERP_SMOOTHING_MAX)
+ */
+void lv_gaggiuino_set_smoothing(uint16_t percent)
+{
+    smoothing = percent;
+}
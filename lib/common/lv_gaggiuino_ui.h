@@ -18,20 +18,49 @@ extern "C" {
 void lv_gaggiuino_ui_init(void);
 
 /**
- * Update the text of an object
+ * Get the time from lv_gaggiuino_ui_init() until the main UI was shown
+ * @return The time in ms, 0 while the splash is still shown
+ */
+uint32_t lv_gaggiuino_get_tti(void);
+
+/**
+ * Update the text of an object. The text is copied once, into the model; labels show the
+ * model's copy.
  * @param object The object to update
- * @param text The text to update the object with
+ * @param text The text to update the object with, not necessarily terminated
+ * @param len The number of characters
+ */
+void lv_gaggiuino_update_text(const char* object, const char* text, size_t len);
+
+/**
+ * Update a numeric value, e.g. `pressure.val=90` or `currentTemp=93`
+ * @param name The object or variable name
+ * @param value The value
+ */
+void lv_gaggiuino_update_value(const char* name, int32_t value);
+
+/**
+ * Get the Nextion name of an object
+ * @param obj The object to look up
+ * @return The name, e.g. "home.qPf1", or NULL if the object has none
  */
-void lv_gaggiuino_update_text(const char* object, const char* text);
+const char * lv_gaggiuino_get_object_name(const lv_obj_t * obj);
 
 /**
- * Show a modal message window
- * @param message The message to display
+ * Get the page an object stands for, to group objects by page
+ * @param obj The object to look up
+ * @return The page name for the tab of a page, the splash screen or the popup window, NULL otherwise
+ */
+const char * lv_gaggiuino_get_page_name(const lv_obj_t * obj);
+
+/**
+ * Queue the current popupMSG.t0 text for the modal message window.
+ * Repeated messages are dropped and bursts coalesced, see popup_queue.h.
  */
 void lv_gaggiuino_show_popup(void);
 
 /**
- * Hide the modal message window
+ * Close the modal message window, the next queued message is shown instead if there is one
  */
 void lv_gaggiuino_hide_popup(void);
 
@@ -41,6 +70,38 @@ void lv_gaggiuino_hide_popup(void);
  */
 void lv_gaggiuino_show_page(const char* page);
 
+/**
+ * Print the LVGL heap each page took to build (`used`), its high-water mark above the state before
+ * building up to the first render (`peak`) and the largest free block left then, one
+ * `page.<name>.heap.<stat> value` line each
+ */
+void lv_gaggiuino_print_page_heap(void);
+
+/**
+ * Set how long a page may stay hidden before its widgets are deleted.
+ * Pages are built on their first visit and rebuilt from the stored values when shown again.
+ * @param timeout_ms idle time in ms, 0 to keep pages once they are built
+ */
+void lv_gaggiuino_set_page_idle_timeout(uint32_t timeout_ms);
+
+/**
+ * Get how long a page may stay hidden before its widgets are deleted
+ * @return idle time in ms, 0 if pages are kept once they are built
+ */
+uint32_t lv_gaggiuino_get_page_idle_timeout(void);
+
+/**
+ * Get how many times pages were built, first builds and rebuilds after an idle timeout
+ */
+uint32_t lv_gaggiuino_get_page_builds(void);
+
+/**
+ * Set how smoothly gauges and readouts move between telemetry samples
+ * @param percent time a change takes in % of the measured sample interval, 0 shows samples
+ *                right away, higher values are smoother but lag more (at most 400)
+ */
+void lv_gaggiuino_set_smoothing(uint16_t percent);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
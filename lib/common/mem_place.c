@@ -0,0 +1,202 @@
+/**
+ * @file mem_place.c
+ * Placement of large buffers in internal RAM or PSRAM by how they are used.
+ * On the host the two pools are simulated with their capacities and access latencies.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "mem_place.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_heap_caps.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HDR_SIZE    16      // Keeps the buffer as aligned as the block of the pool
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t size;
+    uint8_t pool;
+} block_hdr_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool pool_has_room(mem_place_pool_t pool, size_t size);
+static void * pool_alloc(mem_place_pool_t pool, size_t size);
+static void pool_free(mem_place_pool_t pool, void * raw);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static mem_place_stats_t pool_stats[MEM_PLACE_POOL_COUNT];
+
+static const uint32_t weights[MEM_PLACE_POOL_COUNT] = {
+    [MEM_PLACE_INTERNAL] = MEM_PLACE_INTERNAL_WEIGHT,
+    [MEM_PLACE_PSRAM] = MEM_PLACE_PSRAM_WEIGHT,
+};
+
+static const char * const pool_names[MEM_PLACE_POOL_COUNT] = {
+    [MEM_PLACE_INTERNAL] = "internal",
+    [MEM_PLACE_PSRAM] = "psram",
+};
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if defined(ESP_PLATFORM)
+
+static const uint32_t caps[MEM_PLACE_POOL_COUNT] = {
+    [MEM_PLACE_INTERNAL] = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    [MEM_PLACE_PSRAM] = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+};
+
+static bool pool_has_room(mem_place_pool_t pool, size_t size)
+{
+    if (pool != MEM_PLACE_INTERNAL) return true;   // Let the allocation decide
+    return heap_caps_get_largest_free_block(caps[pool]) >= size &&
+           heap_caps_get_free_size(caps[pool]) >= size + MEM_PLACE_INTERNAL_RESERVE;
+}
+
+static void * pool_alloc(mem_place_pool_t pool, size_t size)
+{
+    return heap_caps_malloc(size, caps[pool]);
+}
+
+static void pool_free(mem_place_pool_t pool, void * raw)
+{
+    (void)pool;
+    heap_caps_free(raw);
+}
+
+#else
+
+// Both pools come from malloc, only their capacity is simulated
+static const uint32_t sim_size[MEM_PLACE_POOL_COUNT] = {
+    [MEM_PLACE_INTERNAL] = MEM_PLACE_SIM_INTERNAL_SIZE,
+    [MEM_PLACE_PSRAM] = MEM_PLACE_SIM_PSRAM_SIZE,
+};
+
+static bool pool_has_room(mem_place_pool_t pool, size_t size)
+{
+    uint32_t reserve = pool == MEM_PLACE_INTERNAL ? MEM_PLACE_INTERNAL_RESERVE : 0;
+    return pool_stats[pool].used + size + reserve <= sim_size[pool];
+}
+
+static void * pool_alloc(mem_place_pool_t pool, size_t size)
+{
+    if (!pool_has_room(pool, size)) return NULL;
+    return malloc(size);
+}
+
+static void pool_free(mem_place_pool_t pool, void * raw)
+{
+    (void)pool;
+    free(raw);
+}
+
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void * mem_place_alloc(size_t size, mem_place_use_t use)
+{
+    size_t total = size + HDR_SIZE;
+
+    mem_place_pool_t preferred = MEM_PLACE_PSRAM;
+    if (use == MEM_PLACE_RENDER || (use == MEM_PLACE_HOT && size <= MEM_PLACE_HOT_MAX)) {
+        preferred = MEM_PLACE_INTERNAL;
+    }
+
+    // Internal RAM without room for the block and its reserve counts as full, like a failed allocation
+    mem_place_pool_t pool = preferred;
+    uint8_t * raw = pool_has_room(pool, total) ? pool_alloc(pool, total) : NULL;
+    if (raw == NULL) {
+        pool = preferred == MEM_PLACE_INTERNAL ? MEM_PLACE_PSRAM : MEM_PLACE_INTERNAL;
+        raw = pool_alloc(pool, total);
+        if (raw == NULL) return NULL;
+        pool_stats[preferred].fallbacks++;
+        if (use == MEM_PLACE_RENDER) {
+            LV_LOG_WARN("mem_place: no internal RAM for a %u byte render buffer, placed in PSRAM", (unsigned)size);
+        }
+    }
+
+    block_hdr_t * hdr = (block_hdr_t *)raw;
+    hdr->size = (uint32_t)total;
+    hdr->pool = (uint8_t)pool;
+
+    mem_place_stats_t * s = &pool_stats[pool];
+    s->used += total;
+    s->blocks++;
+    if (s->used > s->peak) s->peak = s->used;
+    return raw + HDR_SIZE;
+}
+
+void mem_place_free(void * p)
+{
+    if (p == NULL) return;
+
+    block_hdr_t * hdr = (block_hdr_t *)((uint8_t *)p - HDR_SIZE);
+    mem_place_stats_t * s = &pool_stats[hdr->pool];
+    s->used -= hdr->size;
+    s->blocks--;
+    pool_free((mem_place_pool_t)hdr->pool, hdr);
+}
+
+mem_place_pool_t mem_place_get_pool(const void * p)
+{
+    const block_hdr_t * hdr = (const block_hdr_t *)((const uint8_t *)p - HDR_SIZE);
+    return (mem_place_pool_t)hdr->pool;
+}
+
+void mem_place_touch(const void * p, uint32_t bytes)
+{
+    if (p == NULL) return;
+    pool_stats[mem_place_get_pool(p)].touched += bytes;
+}
+
+void mem_place_get_stats(mem_place_pool_t pool, mem_place_stats_t * stats)
+{
+    *stats = pool_stats[pool];
+}
+
+uint64_t mem_place_get_cost(void)
+{
+    uint64_t cost = 0;
+    for (int i = 0; i < MEM_PLACE_POOL_COUNT; i++) {
+        cost += pool_stats[i].touched * weights[i];
+    }
+    return cost;
+}
+
+void mem_place_print(void)
+{
+    uint64_t touched = 0;
+    for (int i = 0; i < MEM_PLACE_POOL_COUNT; i++) {
+        const mem_place_stats_t * s = &pool_stats[i];
+        printf("place.%s.used %u\n", pool_names[i], (unsigned)s->used);
+        printf("place.%s.peak %u\n", pool_names[i], (unsigned)s->peak);
+        printf("place.%s.blocks %u\n", pool_names[i], (unsigned)s->blocks);
+        printf("place.%s.fallbacks %u\n", pool_names[i], (unsigned)s->fallbacks);
+        printf("place.%s.touched %llu\n", pool_names[i], (unsigned long long)s->touched);
+        touched += s->touched;
+    }
+
+    // Compared to everything in internal RAM, the best case
+    printf("place.cost %llu\n", (unsigned long long)mem_place_get_cost());
+    printf("place.cost_internal_only %llu\n", (unsigned long long)(touched * MEM_PLACE_INTERNAL_WEIGHT));
+}
@@ -0,0 +1,120 @@
+/**
+ * @file mem_place.h
+ * Placement of large buffers in internal RAM or PSRAM by how they are used.
+ * On the host the two pools are simulated with their capacities and access latencies.
+ */
+
+#ifndef MEM_PLACE_H
+#define MEM_PLACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef MEM_PLACE_HOT_MAX
+#define MEM_PLACE_HOT_MAX           (16U * 1024U)   // Larger hot buffers go to PSRAM
+#endif
+#ifndef MEM_PLACE_INTERNAL_RESERVE
+#define MEM_PLACE_INTERNAL_RESERVE  (48U * 1024U)   // Internal RAM left for stacks, WiFi, LVGL, ...
+#endif
+
+// Relative cost of touching a byte, PSRAM is behind the cache and the octal SPI bus
+#ifndef MEM_PLACE_INTERNAL_WEIGHT
+#define MEM_PLACE_INTERNAL_WEIGHT   1
+#endif
+#ifndef MEM_PLACE_PSRAM_WEIGHT
+#define MEM_PLACE_PSRAM_WEIGHT      4
+#endif
+
+// Pool sizes simulated on the host, like an ESP32-S3 with 8 MB PSRAM
+#ifndef MEM_PLACE_SIM_INTERNAL_SIZE
+#define MEM_PLACE_SIM_INTERNAL_SIZE (320U * 1024U)
+#endif
+#ifndef MEM_PLACE_SIM_PSRAM_SIZE
+#define MEM_PLACE_SIM_PSRAM_SIZE    (8U * 1024U * 1024U)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    MEM_PLACE_INTERNAL,
+    MEM_PLACE_PSRAM,
+    MEM_PLACE_POOL_COUNT
+} mem_place_pool_t;
+
+typedef enum {
+    MEM_PLACE_RENDER,   // Written for every rendered pixel, e.g. draw buffers: internal whenever it fits
+    MEM_PLACE_HOT,      // Touched on most frames: internal up to MEM_PLACE_HOT_MAX
+    MEM_PLACE_COLD,     // Large assets, caches and histories: PSRAM
+} mem_place_use_t;
+
+typedef struct {
+    uint32_t used;          // Bytes held
+    uint32_t peak;
+    uint32_t blocks;
+    uint32_t fallbacks;     // Blocks that preferred this pool and were placed in the other one
+    uint64_t touched;       // Bytes reported with mem_place_touch()
+} mem_place_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Allocate a buffer in the pool preferred for its use, or in the other one if that is full
+ * @param size size in bytes
+ * @param use how the buffer is accessed
+ * @return the buffer, NULL if neither pool has room
+ */
+void * mem_place_alloc(size_t size, mem_place_use_t use);
+
+/**
+ * Free a buffer of mem_place_alloc()
+ * @param p the buffer, NULL is ignored
+ */
+void mem_place_free(void * p);
+
+/**
+ * Get the pool a buffer of mem_place_alloc() was placed in
+ */
+mem_place_pool_t mem_place_get_pool(const void * p);
+
+/**
+ * Record an access to a buffer, for the cost estimate of the placement
+ * @param p a buffer of mem_place_alloc()
+ * @param bytes number of bytes read or written
+ */
+void mem_place_touch(const void * p, uint32_t bytes);
+
+/**
+ * Get the usage of a pool
+ * @param pool the pool
+ * @param stats store the usage here
+ */
+void mem_place_get_stats(mem_place_pool_t pool, mem_place_stats_t * stats);
+
+/**
+ * Get the access cost of the recorded touches, the bytes of each pool times its weight
+ */
+uint64_t mem_place_get_cost(void);
+
+/**
+ * Print the usage of both pools and the access cost to stdout
+ */
+void mem_place_print(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*MEM_PLACE_H*/
@@ -0,0 +1,630 @@
+/**
+ * @file mem_pool.c
+ * LVGL heap: size-class slabs for small blocks and a two-level segregated fit arena for the rest,
+ * with usage accounting per tag. Plugged in with LV_MEM_CUSTOM_ALLOC/FREE/REALLOC.
+ *
+ * The heap is one static array, its first MEM_POOL_SLAB_SIZE bytes are pages of equally sized
+ * slots, the rest is the arena. Arena blocks start with an 8 byte header of offsets instead of
+ * pointers, so the layout and the fragmentation are the same on the ESP32 and on the host.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mem_pool.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ALIGN           8U
+#define HDR_SIZE        8U
+#define MIN_PAYLOAD     8U          // Room for the free list links
+#define FREE_BIT        0x1U
+#define SIZE_MASK       0x00FFFFF8U
+#define TAG_SHIFT       24
+#define OFF_NONE        UINT32_MAX
+
+// Two-level segregated fit: power of two ranges, each split in SL_COUNT linear steps
+#define SL_LOG2         4
+#define SL_COUNT        (1U << SL_LOG2)
+#define FL_SHIFT        (SL_LOG2 + 3)       // + log2(ALIGN)
+#define SMALL_SIZE      (1U << FL_SHIFT)    // Smaller blocks are all in the first range
+#define FL_COUNT        18                  // Up to the largest size of SIZE_MASK
+
+#define ARENA_SIZE      (MEM_POOL_SIZE - MEM_POOL_SLAB_SIZE)
+#define SLAB_PAGES      (MEM_POOL_SLAB_SIZE / MEM_POOL_PAGE_SIZE)
+#define SLAB_MIN        16U
+#define SLOTS_MAX       (MEM_POOL_PAGE_SIZE / SLAB_MIN)
+#define CLASS_NONE      0xFF
+#define SLOT_NONE       0xFF
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t prev_phys;     // Offset of the previous block in the arena, OFF_NONE for the first
+    uint32_t size_flags;    // Payload size | tag << TAG_SHIFT | FREE_BIT
+} block_t;
+
+typedef struct {
+    uint32_t next;          // Offsets of the neighbours in the free list
+    uint32_t prev;
+} links_t;
+
+typedef struct {
+    uint8_t cls;            // Size class, CLASS_NONE if the page is unused
+    uint8_t used;
+    uint8_t free_head;      // First freed slot, the next one is stored in its first byte
+    uint8_t fresh;          // Slots from here on were never used
+    uint8_t tags[SLOTS_MAX];
+} page_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void pool_init(void);
+static void * alloc_tagged(size_t size, mem_tag_t tag);
+static void account(mem_tag_t tag, int32_t bytes, int32_t blocks);
+static void * slab_alloc(uint8_t cls, mem_tag_t tag);
+static void slab_free(uint8_t * p);
+static void mapping(uint32_t size, uint32_t * fl, uint32_t * sl);
+static void insert_free(block_t * b);
+static void remove_free(block_t * b);
+static block_t * find_free(uint32_t size);
+static void * arena_alloc(uint32_t size, mem_tag_t tag);
+static void arena_release(block_t * b);
+static void arena_split(block_t * b, uint32_t size);
+static uint32_t check_slabs(mem_tag_stats_t * found);
+static uint32_t check_arena(mem_tag_stats_t * found);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint64_t pool_mem[MEM_POOL_SIZE / sizeof(uint64_t)];
+#define SLAB_BASE   ((uint8_t *)pool_mem)
+#define ARENA_BASE  ((uint8_t *)pool_mem + MEM_POOL_SLAB_SIZE)
+
+static const uint16_t class_sizes[] = {16, 32, 48, 64, 96, 128};
+#define CLASS_COUNT (sizeof(class_sizes) / sizeof(class_sizes[0]))
+
+static page_t pages[SLAB_PAGES];
+static uint8_t class_hint[CLASS_COUNT];     // Page a class allocated from last
+
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[FL_COUNT];
+static uint32_t heads[FL_COUNT][SL_COUNT];
+
+static bool ready;
+static mem_tag_t cur_tag;
+static mem_tag_stats_t tag_stats[MEM_TAG_COUNT];
+static mem_pool_stats_t stats;
+
+static const char * const tag_names[MEM_TAG_COUNT] = {
+    [MEM_TAG_OTHER] = "other",
+    [MEM_TAG_WIDGETS] = "widgets",
+    [MEM_TAG_STYLES] = "styles",
+    [MEM_TAG_TEXT] = "text",
+    [MEM_TAG_DRAW] = "draw",
+};
+
+/**********************
+ *      MACROS
+ **********************/
+#define FLS(x)  (31 - __builtin_clz(x))
+#define FFS(x)  ((uint32_t)__builtin_ctz(x))
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline block_t * blk(uint32_t off) { return (block_t *)(ARENA_BASE + off); }
+static inline uint32_t blk_off(const block_t * b) { return (uint32_t)((const uint8_t *)b - ARENA_BASE); }
+static inline uint32_t blk_size(const block_t * b) { return b->size_flags & SIZE_MASK; }
+static inline bool blk_is_free(const block_t * b) { return b->size_flags & FREE_BIT; }
+static inline mem_tag_t blk_tag(const block_t * b) { return (mem_tag_t)(b->size_flags >> TAG_SHIFT); }
+static inline block_t * blk_next(const block_t * b) { return blk(blk_off(b) + HDR_SIZE + blk_size(b)); }
+static inline links_t * blk_links(block_t * b) { return (links_t *)((uint8_t *)b + HDR_SIZE); }
+
+static void pool_init(void)
+{
+    for (uint32_t i = 0; i < SLAB_PAGES; i++) {
+        pages[i].cls = CLASS_NONE;
+    }
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++) {
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++) {
+            heads[fl][sl] = OFF_NONE;
+        }
+    }
+
+    // One free block and a used zero size block at the end, so no block needs a bounds check
+    block_t * first = blk(0);
+    first->prev_phys = OFF_NONE;
+    first->size_flags = (ARENA_SIZE - 2 * HDR_SIZE) | FREE_BIT;
+    block_t * sentinel = blk(ARENA_SIZE - HDR_SIZE);
+    sentinel->prev_phys = 0;
+    sentinel->size_flags = 0;
+    insert_free(first);
+
+    stats.slab_pages_max = SLAB_PAGES;
+    stats.arena_size = ARENA_SIZE;
+    ready = true;
+}
+
+static void * alloc_tagged(size_t size, mem_tag_t tag)
+{
+    if (!ready) pool_init();
+
+    void * p = NULL;
+    if (size <= MEM_POOL_SLAB_MAX) {
+        uint8_t cls = 0;
+        while (class_sizes[cls] < size) cls++;
+        p = slab_alloc(cls, tag);
+        if (p == NULL) stats.slab_fallbacks++;
+    }
+    if (p == NULL && size <= SIZE_MASK) p = arena_alloc((uint32_t)size, tag);
+    if (p == NULL) stats.failed++;
+    return p;
+}
+
+static void account(mem_tag_t tag, int32_t bytes, int32_t blocks)
+{
+    mem_tag_stats_t * t = &tag_stats[tag];
+    t->used += bytes;
+    t->blocks += blocks;
+    if (t->used > t->peak) t->peak = t->used;
+    stats.used += bytes;
+    if (stats.used > stats.peak) stats.peak = stats.used;
+    if (stats.used > stats.window_peak) stats.window_peak = stats.used;
+}
+
+static void * slab_alloc(uint8_t cls, mem_tag_t tag)
+{
+    uint16_t size = class_sizes[cls];
+    uint8_t slots = MEM_POOL_PAGE_SIZE / size;
+
+    // The last page of the class usually has room, otherwise any page of the class or a new one
+    uint32_t idx = class_hint[cls];
+    page_t * page = &pages[idx];
+    if (page->cls != cls || (page->free_head == SLOT_NONE && page->fresh == slots)) {
+        page = NULL;
+        uint32_t unused = SLAB_PAGES;
+        for (idx = 0; idx < SLAB_PAGES; idx++) {
+            page_t * candidate = &pages[idx];
+            if (candidate->cls == cls && (candidate->free_head != SLOT_NONE || candidate->fresh < slots)) {
+                page = candidate;
+                break;
+            }
+            if (candidate->cls == CLASS_NONE && unused == SLAB_PAGES) unused = idx;
+        }
+        if (page == NULL) {
+            if (unused == SLAB_PAGES) return NULL;
+            idx = unused;
+            page = &pages[idx];
+            page->cls = cls;
+            page->used = 0;
+            page->free_head = SLOT_NONE;
+            page->fresh = 0;
+            stats.slab_pages++;
+        }
+        class_hint[cls] = (uint8_t)idx;
+    }
+
+    uint8_t * base = SLAB_BASE + idx * MEM_POOL_PAGE_SIZE;
+    uint8_t slot;
+    if (page->free_head != SLOT_NONE) {
+        slot = page->free_head;
+        page->free_head = base[slot * size];
+    } else {
+        slot = page->fresh++;
+    }
+    page->used++;
+    page->tags[slot] = (uint8_t)tag;
+
+    stats.slab_used += size;
+    account(tag, size, 1);
+    return base + slot * size;
+}
+
+static void slab_free(uint8_t * p)
+{
+    uint32_t idx = (uint32_t)(p - SLAB_BASE) / MEM_POOL_PAGE_SIZE;
+    page_t * page = &pages[idx];
+    uint16_t size = class_sizes[page->cls];
+    uint8_t slot = (uint8_t)(((uint32_t)(p - SLAB_BASE) % MEM_POOL_PAGE_SIZE) / size);
+
+    p[0] = page->free_head;
+    page->free_head = slot;
+    page->used--;
+
+    stats.slab_used -= size;
+    account((mem_tag_t)page->tags[slot], -(int32_t)size, -1);
+
+    // An empty page can serve any class again
+    if (page->used == 0) {
+        page->cls = CLASS_NONE;
+        stats.slab_pages--;
+    }
+}
+
+static void mapping(uint32_t size, uint32_t * fl, uint32_t * sl)
+{
+    if (size < SMALL_SIZE) {
+        *fl = 0;
+        *sl = size / ALIGN;
+    } else {
+        uint32_t f = FLS(size);
+        *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+        *fl = f - FL_SHIFT + 1;
+    }
+}
+
+static void insert_free(block_t * b)
+{
+    uint32_t fl, sl;
+    mapping(blk_size(b), &fl, &sl);
+
+    uint32_t off = blk_off(b);
+    links_t * l = blk_links(b);
+    l->prev = OFF_NONE;
+    l->next = heads[fl][sl];
+    if (l->next != OFF_NONE) blk_links(blk(l->next))->prev = off;
+    heads[fl][sl] = off;
+
+    fl_bitmap |= 1U << fl;
+    sl_bitmap[fl] |= 1U << sl;
+}
+
+static void remove_free(block_t * b)
+{
+    uint32_t fl, sl;
+    mapping(blk_size(b), &fl, &sl);
+
+    links_t * l = blk_links(b);
+    if (l->next != OFF_NONE) blk_links(blk(l->next))->prev = l->prev;
+    if (l->prev != OFF_NONE) {
+        blk_links(blk(l->prev))->next = l->next;
+    } else {
+        heads[fl][sl] = l->next;
+        if (l->next == OFF_NONE) {
+            sl_bitmap[fl] &= ~(1U << sl);
+            if (sl_bitmap[fl] == 0) fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+/**
+ * Get a free block of at least `size` bytes in constant time. The size is rounded up to the
+ * next list, so any block of that list fits.
+ */
+static block_t * find_free(uint32_t size)
+{
+    if (size >= SMALL_SIZE) size += (1U << (FLS(size) - SL_LOG2)) - 1;
+
+    uint32_t fl, sl;
+    mapping(size, &fl, &sl);
+    if (fl >= FL_COUNT) return NULL;
+
+    uint32_t sl_map = sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = fl + 1 < 32 ? fl_bitmap & (~0U << (fl + 1)) : 0;
+        if (fl_map == 0) return NULL;
+        fl = FFS(fl_map);
+        sl_map = sl_bitmap[fl];
+    }
+    return blk(heads[fl][FFS(sl_map)]);
+}
+
+static void * arena_alloc(uint32_t size, mem_tag_t tag)
+{
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+    if (size < MIN_PAYLOAD) size = MIN_PAYLOAD;
+
+    block_t * b = find_free(size);
+    if (b == NULL) return NULL;
+
+    remove_free(b);
+    b->size_flags = blk_size(b) | ((uint32_t)tag << TAG_SHIFT);
+    arena_split(b, size);
+
+    account(tag, blk_size(b), 1);
+    return blk_links(b);
+}
+
+/**
+ * Return a block to the free lists, merged with its free neighbours
+ */
+static void arena_release(block_t * b)
+{
+    b->size_flags = blk_size(b) | FREE_BIT;
+
+    block_t * next = blk_next(b);
+    if (blk_is_free(next)) {
+        remove_free(next);
+        b->size_flags = (blk_size(b) + HDR_SIZE + blk_size(next)) | FREE_BIT;
+    }
+    if (b->prev_phys != OFF_NONE) {
+        block_t * prev = blk(b->prev_phys);
+        if (blk_is_free(prev)) {
+            remove_free(prev);
+            prev->size_flags = (blk_size(prev) + HDR_SIZE + blk_size(b)) | FREE_BIT;
+            b = prev;
+        }
+    }
+    blk_next(b)->prev_phys = blk_off(b);
+    insert_free(b);
+}
+
+/**
+ * Shrink a used block to `size` and release the rest if it's large enough for a block
+ */
+static void arena_split(block_t * b, uint32_t size)
+{
+    uint32_t rest = blk_size(b) - size;
+    if (rest < HDR_SIZE + MIN_PAYLOAD) return;
+
+    b->size_flags = size | (b->size_flags & ~SIZE_MASK);
+    block_t * r = blk_next(b);
+    r->prev_phys = blk_off(b);
+    r->size_flags = rest - HDR_SIZE;
+    blk_next(r)->prev_phys = blk_off(r);
+    arena_release(r);
+}
+
+/**
+ * Check the used slab pages and add their used slots to `found`
+ * @return the number of inconsistencies
+ */
+static uint32_t check_slabs(mem_tag_stats_t * found)
+{
+    uint32_t errors = 0;
+    uint32_t used_pages = 0;
+    uint32_t used_bytes = 0;
+    bool freed[SLOTS_MAX];
+
+    for (uint32_t idx = 0; idx < SLAB_PAGES; idx++) {
+        page_t * page = &pages[idx];
+        if (page->cls == CLASS_NONE) continue;
+        if (page->cls >= CLASS_COUNT) {
+            errors++;
+            continue;
+        }
+
+        uint16_t size = class_sizes[page->cls];
+        uint8_t slots = MEM_POOL_PAGE_SIZE / size;
+        used_pages++;
+        if (page->used == 0 || page->fresh > slots || page->used > page->fresh) errors++;
+
+        // The freed slots are the fresh ones minus the used ones, each listed once
+        memset(freed, 0, sizeof(freed));
+        uint8_t * base = SLAB_BASE + idx * MEM_POOL_PAGE_SIZE;
+        uint32_t freed_cnt = 0;
+        for (uint8_t slot = page->free_head; slot != SLOT_NONE; slot = base[slot * size]) {
+            if (slot >= page->fresh || freed[slot]) {
+                errors++;
+                break;
+            }
+            freed[slot] = true;
+            freed_cnt++;
+        }
+        if (freed_cnt + page->used != page->fresh) errors++;
+
+        for (uint8_t slot = 0; slot < page->fresh; slot++) {
+            if (freed[slot]) continue;
+            if (page->tags[slot] >= MEM_TAG_COUNT) {
+                errors++;
+                continue;
+            }
+            found[page->tags[slot]].used += size;
+            found[page->tags[slot]].blocks++;
+            used_bytes += size;
+        }
+    }
+
+    if (used_pages != stats.slab_pages || used_bytes != stats.slab_used) errors++;
+    return errors;
+}
+
+/**
+ * Check the block chain and the free lists of the arena and add the used blocks to `found`
+ * @return the number of inconsistencies
+ */
+static uint32_t check_arena(mem_tag_stats_t * found)
+{
+    uint32_t errors = 0;
+    uint32_t free_blocks = 0;
+    uint32_t prev = OFF_NONE;
+    bool prev_free = false;
+
+    // Physical chain: linked back, aligned, no two free neighbours, ends at the sentinel
+    block_t * b = blk(0);
+    while (blk_size(b) != 0) {
+        uint32_t off = blk_off(b);
+        if (b->prev_phys != prev || blk_size(b) % ALIGN != 0 || blk_size(b) < MIN_PAYLOAD ||
+            off + 2 * HDR_SIZE + blk_size(b) > ARENA_SIZE) {
+            return errors + 1;
+        }
+        if (blk_is_free(b)) {
+            if (prev_free) errors++;
+            free_blocks++;
+        } else if (blk_tag(b) >= MEM_TAG_COUNT) {
+            errors++;
+        } else {
+            found[blk_tag(b)].used += blk_size(b);
+            found[blk_tag(b)].blocks++;
+        }
+        prev_free = blk_is_free(b);
+        prev = off;
+        b = blk_next(b);
+    }
+    if (blk_off(b) != ARENA_SIZE - HDR_SIZE || b->prev_phys != prev || blk_is_free(b)) errors++;
+
+    // Free lists: every free block once, in the list of its size, with the bitmaps matching
+    uint32_t listed = 0;
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++) {
+        if (((fl_bitmap >> fl) & 1U) != (sl_bitmap[fl] != 0)) errors++;
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++) {
+            if (((sl_bitmap[fl] >> sl) & 1U) != (heads[fl][sl] != OFF_NONE)) errors++;
+
+            uint32_t link_prev = OFF_NONE;
+            for (uint32_t off = heads[fl][sl]; off != OFF_NONE; off = blk_links(blk(off))->next) {
+                if (off >= ARENA_SIZE - HDR_SIZE || ++listed > free_blocks) return errors + 1;
+                block_t * f = blk(off);
+                uint32_t f_fl, f_sl;
+                mapping(blk_size(f), &f_fl, &f_sl);
+                if (!blk_is_free(f) || f_fl != fl || f_sl != sl || blk_links(f)->prev != link_prev) errors++;
+                link_prev = off;
+            }
+        }
+    }
+    if (listed != free_blocks) errors++;
+    return errors;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void * mem_pool_alloc(size_t size)
+{
+    stats.allocs++;
+    return alloc_tagged(size, cur_tag);
+}
+
+void mem_pool_free(void * p)
+{
+    uint8_t * bytes = p;
+    if (bytes < SLAB_BASE || bytes >= SLAB_BASE + MEM_POOL_SIZE) return;
+
+    if (bytes < ARENA_BASE) {
+        slab_free(bytes);
+        return;
+    }
+
+    block_t * b = (block_t *)(bytes - HDR_SIZE);
+    account(blk_tag(b), -(int32_t)blk_size(b), -1);
+    arena_release(b);
+}
+
+void * mem_pool_realloc(void * p, size_t size)
+{
+    uint8_t * bytes = p;
+    if (bytes < SLAB_BASE || bytes >= SLAB_BASE + MEM_POOL_SIZE) return mem_pool_alloc(size);
+    stats.allocs++;
+
+    size_t old_size;
+    mem_tag_t tag;
+    if (bytes < ARENA_BASE) {
+        page_t * page = &pages[(uint32_t)(bytes - SLAB_BASE) / MEM_POOL_PAGE_SIZE];
+        old_size = class_sizes[page->cls];
+        if (size <= old_size) return p;
+        tag = (mem_tag_t)page->tags[((uint32_t)(bytes - SLAB_BASE) % MEM_POOL_PAGE_SIZE) / old_size];
+    } else {
+        block_t * b = (block_t *)(bytes - HDR_SIZE);
+        old_size = blk_size(b);
+        tag = blk_tag(b);
+
+        uint32_t new_size = (uint32_t)((size + ALIGN - 1) & ~(ALIGN - 1));
+        if (new_size < MIN_PAYLOAD) new_size = MIN_PAYLOAD;
+
+        // Shrink in place, or grow into a free neighbour
+        block_t * next = blk_next(b);
+        if (new_size > old_size && blk_is_free(next) && old_size + HDR_SIZE + blk_size(next) >= new_size) {
+            remove_free(next);
+            b->size_flags = (old_size + HDR_SIZE + blk_size(next)) | (b->size_flags & ~SIZE_MASK);
+            blk_next(b)->prev_phys = blk_off(b);
+        }
+        if (new_size <= blk_size(b)) {
+            arena_split(b, new_size);
+            account(tag, (int32_t)blk_size(b) - (int32_t)old_size, 0);
+            return p;
+        }
+    }
+
+    void * moved = alloc_tagged(size, tag);
+    if (moved == NULL) return NULL;
+    memcpy(moved, p, old_size < size ? old_size : size);
+    mem_pool_free(p);
+    return moved;
+}
+
+mem_tag_t mem_pool_set_tag(mem_tag_t tag)
+{
+    mem_tag_t prev = cur_tag;
+    cur_tag = tag;
+    return prev;
+}
+
+const char * mem_pool_get_tag_name(mem_tag_t tag)
+{
+    return tag < MEM_TAG_COUNT ? tag_names[tag] : "";
+}
+
+void mem_pool_get_tag_stats(mem_tag_t tag, mem_tag_stats_t * out)
+{
+    *out = tag_stats[tag];
+}
+
+void mem_pool_get_stats(mem_pool_stats_t * out)
+{
+    if (!ready) pool_init();
+
+    // Walk the arena for the free space, this is only done for reports
+    stats.arena_free = 0;
+    stats.arena_largest = 0;
+    for (block_t * b = blk(0); blk_size(b) != 0; b = blk_next(b)) {
+        if (!blk_is_free(b)) continue;
+        stats.arena_free += blk_size(b);
+        if (blk_size(b) > stats.arena_largest) stats.arena_largest = blk_size(b);
+    }
+    stats.arena_frag_pct = stats.arena_free ? 100 - (uint32_t)((uint64_t)stats.arena_largest * 100 / stats.arena_free) : 0;
+
+    *out = stats;
+}
+
+uint32_t mem_pool_check(void)
+{
+    if (!ready) pool_init();
+
+    mem_tag_stats_t found[MEM_TAG_COUNT];
+    memset(found, 0, sizeof(found));
+    uint32_t errors = check_slabs(found) + check_arena(found);
+
+    // The accounting per tag adds up to the blocks actually held
+    uint32_t used = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        if (found[i].used != tag_stats[i].used || found[i].blocks != tag_stats[i].blocks) errors++;
+        used += found[i].used;
+    }
+    if (used != stats.used) errors++;
+    return errors;
+}
+
+void mem_pool_reset_window_peak(void)
+{
+    stats.window_peak = stats.used;
+}
+
+void mem_pool_print(void)
+{
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        printf("mem.%s.used %u\n", tag_names[i], (unsigned)tag_stats[i].used);
+        printf("mem.%s.peak %u\n", tag_names[i], (unsigned)tag_stats[i].peak);
+        printf("mem.%s.blocks %u\n", tag_names[i], (unsigned)tag_stats[i].blocks);
+    }
+
+    mem_pool_stats_t s;
+    mem_pool_get_stats(&s);
+    printf("mem.used %u\n", (unsigned)s.used);
+    printf("mem.peak %u\n", (unsigned)s.peak);
+    printf("mem.allocs %u\n", (unsigned)s.allocs);
+    printf("mem.slab.pages %u/%u\n", (unsigned)s.slab_pages, (unsigned)s.slab_pages_max);
+    printf("mem.slab.used %u\n", (unsigned)s.slab_used);
+    printf("mem.slab.fallbacks %u\n", (unsigned)s.slab_fallbacks);
+    printf("mem.arena.free %u/%u\n", (unsigned)s.arena_free, (unsigned)s.arena_size);
+    printf("mem.arena.largest %u\n", (unsigned)s.arena_largest);
+    printf("mem.arena.frag_pct %u\n", (unsigned)s.arena_frag_pct);
+    printf("mem.failed %u\n", (unsigned)s.failed);
+}
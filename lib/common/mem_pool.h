@@ -0,0 +1,139 @@
+/**
+ * @file mem_pool.h
+ * LVGL heap: size-class slabs for small blocks and a two-level segregated fit arena for the rest,
+ * with usage accounting per tag. Plugged in with LV_MEM_CUSTOM_ALLOC/FREE/REALLOC.
+ */
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef MEM_POOL_SIZE
+#define MEM_POOL_SIZE       (128U * 1024U)  // Whole heap, the former LV_MEM_SIZE
+#endif
+#ifndef MEM_POOL_SLAB_SIZE
+#define MEM_POOL_SLAB_SIZE  (32U * 1024U)   // Part of the heap split into slab pages
+#endif
+#define MEM_POOL_PAGE_SIZE  1024U
+#define MEM_POOL_SLAB_MAX   128U            // Largest block served by a slab
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    MEM_TAG_OTHER,
+    MEM_TAG_WIDGETS,    // Objects created while building pages
+    MEM_TAG_STYLES,     // Theme and shared styles
+    MEM_TAG_TEXT,       // Texts set by the controller
+    MEM_TAG_DRAW,       // Layers and buffers allocated while rendering
+    MEM_TAG_COUNT
+} mem_tag_t;
+
+typedef struct {
+    uint32_t used;      // Bytes held, including the rounding to the block size
+    uint32_t peak;
+    uint32_t blocks;    // Blocks held
+} mem_tag_stats_t;
+
+typedef struct {
+    uint32_t used;              // Bytes held by all tags
+    uint32_t peak;              // Highest `used` since the start
+    uint32_t window_peak;       // Highest `used` since mem_pool_reset_window_peak()
+    uint32_t allocs;            // mem_pool_alloc() and mem_pool_realloc() calls, like malloc() calls for alloc_guard
+    uint32_t slab_pages;        // Pages assigned to a size class
+    uint32_t slab_pages_max;
+    uint32_t slab_used;         // Bytes held in slab pages
+    uint32_t slab_fallbacks;    // Small blocks served by the arena because all pages were taken
+    uint32_t arena_size;
+    uint32_t arena_free;
+    uint32_t arena_largest;     // Largest free block of the arena
+    uint32_t arena_frag_pct;    // 100 - largest free block / free bytes, like lv_mem_monitor()
+    uint32_t failed;            // Allocations that returned NULL
+} mem_pool_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Allocate a block with the current tag
+ * @param size size in bytes
+ * @return the block, 8 byte aligned, NULL if the heap is exhausted
+ */
+void * mem_pool_alloc(size_t size);
+
+/**
+ * Free a block of mem_pool_alloc() or mem_pool_realloc()
+ * @param p the block, NULL is ignored
+ */
+void mem_pool_free(void * p);
+
+/**
+ * Resize a block, growing in place if possible. The block keeps its tag.
+ * @param p the block, NULL to allocate a new one
+ * @param size new size in bytes
+ * @return the block, NULL if the heap is exhausted, `p` is still valid then
+ */
+void * mem_pool_realloc(void * p, size_t size);
+
+/**
+ * Set the tag of the following allocations
+ * @param tag the tag
+ * @return the previous tag, to restore it at the end of a scope
+ */
+mem_tag_t mem_pool_set_tag(mem_tag_t tag);
+
+/**
+ * Get the name of a tag
+ */
+const char * mem_pool_get_tag_name(mem_tag_t tag);
+
+/**
+ * Get the usage of a tag
+ * @param tag the tag
+ * @param stats store the usage here
+ */
+void mem_pool_get_tag_stats(mem_tag_t tag, mem_tag_stats_t * stats);
+
+/**
+ * Get the usage and fragmentation of the heap
+ * @param stats store the statistics here
+ */
+void mem_pool_get_stats(mem_pool_stats_t * stats);
+
+/**
+ * Walk the whole heap and check its structure: the slots of the slab pages, the chain of arena
+ * blocks, the free lists and their bitmaps, and that the usage per tag matches the blocks held.
+ * Takes time proportional to the heap, meant for tests.
+ * @return the number of inconsistencies found, 0 if the heap is sound
+ */
+uint32_t mem_pool_check(void);
+
+/**
+ * Start a new high-water window: set `window_peak` back to the current use of the heap.
+ * The peak of the whole run and the peaks of the tags are kept.
+ */
+void mem_pool_reset_window_peak(void);
+
+/**
+ * Print the usage per tag and the fragmentation to stdout
+ */
+void mem_pool_print(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*MEM_POOL_H*/
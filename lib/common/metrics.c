@@ -0,0 +1,72 @@
+/**
+ * @file metrics.c
+ * Registry of named counters and gauges reported by the UI modules
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "metrics.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char * name;
+    uint32_t value;
+} metric_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static metric_t metrics[METRICS_MAX];
+static uint16_t metric_cnt;
+static uint32_t overflow;   // Handed out when the registry is full
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+uint32_t * metrics_get(const char * name)
+{
+    for (uint16_t i = 0; i < metric_cnt; i++) {
+        if (strcmp(metrics[i].name, name) == 0) return &metrics[i].value;
+    }
+
+    if (metric_cnt == METRICS_MAX) return &overflow;
+
+    metrics[metric_cnt].name = name;
+    metrics[metric_cnt].value = 0;
+    return &metrics[metric_cnt++].value;
+}
+
+uint16_t metrics_get_count(void)
+{
+    return metric_cnt;
+}
+
+const char * metrics_get_name(uint16_t idx)
+{
+    return idx < metric_cnt ? metrics[idx].name : NULL;
+}
+
+uint32_t metrics_get_value(uint16_t idx)
+{
+    return idx < metric_cnt ? metrics[idx].value : 0;
+}
+
+void metrics_reset(void)
+{
+    for (uint16_t i = 0; i < metric_cnt; i++) {
+        metrics[i].value = 0;
+    }
+}
+
+void metrics_print(void)
+{
+    for (uint16_t i = 0; i < metric_cnt; i++) {
+        printf("%s %u\n", metrics[i].name, (unsigned)metrics[i].value);
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file metrics.h
+ * Registry of named counters and gauges reported by the UI modules
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define METRICS_MAX 96
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get a metric, registering it on first use. The lookup compares names, so keep the
+ * returned pointer instead of calling this on every update.
+ * @param name metric name with static storage, e.g. "readout.skipped"
+ * @return the value to update, a scratch value if the registry is full
+ */
+uint32_t * metrics_get(const char * name);
+
+/**
+ * Get the number of registered metrics
+ */
+uint16_t metrics_get_count(void);
+
+/**
+ * Get the name of a metric
+ * @param idx 0 .. metrics_get_count() - 1, in registration order
+ */
+const char * metrics_get_name(uint16_t idx);
+
+/**
+ * Get the value of a metric
+ * @param idx 0 .. metrics_get_count() - 1, in registration order
+ */
+uint32_t metrics_get_value(uint16_t idx);
+
+/**
+ * Set every metric back to 0, they stay registered
+ */
+void metrics_reset(void);
+
+/**
+ * Print every metric as a `name value` line
+ */
+void metrics_print(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*METRICS_H*/
@@ -1,10 +1,10 @@
 #include "nextion_parser.h"
 #include <string.h>
-#include <stdio.h>
 #include <stdlib.h>
 
 #include "../../native-src/serial.h"
 #include "lv_gaggiuino_ui.h"
+#include "frame_arena.h"
 
 // Initialize the message handler
 void nextion_msg_handler_init(void) {
@@ -35,7 +35,7 @@ bool nextion_parser_process_byte(nextion_parser_t* parser, uint8_t byte, nextion
             if (callback != NULL) {
                 // null terminate the buffer
                 parser->buffer[parser->buffer_index - 3] = '\0';
-                callback(parser->buffer, parser->buffer_index - 4);
+                callback(parser->buffer, parser->buffer_index - 3);
             }
             // Reset parser
             nextion_parser_init(parser);
@@ -50,6 +50,12 @@ bool nextion_parser_process_byte(nextion_parser_t* parser, uint8_t byte, nextion
 }
 
 
+// Cut a part out of a command string
+static nextion_str_t slice(const char* start, const char* end) {
+    nextion_str_t str = {start, (uint16_t)(end - start)};
+    return str;
+}
+
 // Parse a string command into a command structure
 nextion_cmd_t nextion_parse_command(const char* cmd_str) {
     nextion_cmd_t cmd;
@@ -57,64 +63,65 @@ nextion_cmd_t nextion_parse_command(const char* cmd_str) {
     cmd.type = NEXTION_CMD_UNKNOWN;
 
     if (cmd_str == NULL) return cmd;
+    const char* cmd_end = cmd_str + strlen(cmd_str);
 
     // Match "get <path>"
     if (strncmp(cmd_str, "get ", 4) == 0) {
-        strncpy(cmd.data.get.path, cmd_str + 4, sizeof(cmd.data.get.path) - 1);
+        cmd.data.get.path = slice(cmd_str + 4, cmd_end);
         cmd.type = NEXTION_CMD_GET;
         return cmd;
     }
 
     // Match "page <name>"
     if (strncmp(cmd_str, "page ", 5) == 0) {
-        strncpy(cmd.data.page.page, cmd_str + 5, sizeof(cmd.data.page.page) - 1);
+        cmd.data.page.page = slice(cmd_str + 5, cmd_end);
         cmd.type = NEXTION_CMD_PAGE;
         return cmd;
     }
 
+    // Match "dbg <what>"
+    if (strncmp(cmd_str, "dbg ", 4) == 0) {
+        cmd.data.debug.what = slice(cmd_str + 4, cmd_end);
+        cmd.type = NEXTION_CMD_DEBUG;
+        return cmd;
+    }
+
     // Match "<obj>.txt=\"value\""
     const char* txt_ptr = strstr(cmd_str, ".txt=\"");
-    if (txt_ptr && cmd_str[strlen(cmd_str) - 1] == '"') {
-        size_t obj_len = txt_ptr - cmd_str;
-        if (obj_len < sizeof(cmd.data.text_assign.object)) {
-            strncpy(cmd.data.text_assign.object, cmd_str, obj_len);
-            cmd.data.text_assign.object[obj_len] = '\0';
-            strncpy(cmd.data.text_assign.value, txt_ptr + 6, strlen(txt_ptr + 6) - 1);
-            cmd.data.text_assign.value[strlen(txt_ptr + 6) - 1] = '\0';
-            cmd.type = NEXTION_CMD_TEXT_ASSIGN;
-            return cmd;
-        }
+    if (txt_ptr && cmd_end - 1 >= txt_ptr + 6 && cmd_end[-1] == '"') {
+        cmd.data.text_assign.object = slice(cmd_str, txt_ptr);
+        cmd.data.text_assign.value = slice(txt_ptr + 6, cmd_end - 1);
+        cmd.type = NEXTION_CMD_TEXT_ASSIGN;
+        return cmd;
     }
 
     // Match "<obj>.val=<number>"
     const char* val_ptr = strstr(cmd_str, ".val=");
     if (val_ptr) {
-        size_t obj_len = val_ptr - cmd_str;
-        if (obj_len < sizeof(cmd.data.value_assign.object)) {
-            strncpy(cmd.data.value_assign.object, cmd_str, obj_len);
-            cmd.data.value_assign.object[obj_len] = '\0';
-            cmd.data.value_assign.value = atoi(val_ptr + 5);
-            cmd.type = NEXTION_CMD_VALUE_ASSIGN;
-            return cmd;
-        }
+        cmd.data.value_assign.object = slice(cmd_str, val_ptr);
+        cmd.data.value_assign.value = atoi(val_ptr + 5);
+        cmd.type = NEXTION_CMD_VALUE_ASSIGN;
+        return cmd;
     }
 
     // Match simple "name=value" (without a dot)
     const char* eq_ptr = strchr(cmd_str, '=');
     if (eq_ptr && strchr(cmd_str, '.') == NULL) {
-        size_t name_len = eq_ptr - cmd_str;
-        if (name_len < sizeof(cmd.data.var_assign.name)) {
-            strncpy(cmd.data.var_assign.name, cmd_str, name_len);
-            cmd.data.var_assign.name[name_len] = '\0';
-            cmd.data.var_assign.value = atoi(eq_ptr + 1);
-            cmd.type = NEXTION_CMD_VAR_ASSIGN;
-            return cmd;
-        }
+        cmd.data.var_assign.name = slice(cmd_str, eq_ptr);
+        cmd.data.var_assign.value = atoi(eq_ptr + 1);
+        cmd.type = NEXTION_CMD_VAR_ASSIGN;
+        return cmd;
     }
 
     return cmd;
 }
 
+// Terminated copy of a name for the lookups, valid until the message is handled
+static const char* name_of(nextion_str_t str) {
+    const char* name = frame_arena_strndup(str.str, str.len);
+    if (name == NULL) NEXTION_LOG("Frame arena full, dropping command for %.*s\n", (int)str.len, str.str);
+    return name;
+}
 
 // Process a complete message from the Nextion parser
 void nextion_msg_handler_process(const uint8_t* message, uint16_t length) {
@@ -123,82 +130,83 @@ void nextion_msg_handler_process(const uint8_t* message, uint16_t length) {
     }
 
     // Treat the message as a string command
-    char* cmd_str = (char*)message;
+    const char* cmd_str = (const char*)message;
     nextion_cmd_t cmd = nextion_parse_command(cmd_str);
-    
+    const char* name;
+
     // Handle the command based on its type
     switch (cmd.type) {
         case NEXTION_CMD_PAGE:
-            // Handle page command
-            printf("Page command: %s\n", cmd.data.page.page);
-            lv_gaggiuino_show_page(cmd.data.page.page);
+            // Handle page command, the page name ends the message
+            NEXTION_LOG("Page command: %s\n", cmd.data.page.page.str);
+            lv_gaggiuino_show_page(cmd.data.page.page.str);
             break;
-            
+
         case NEXTION_CMD_REF:
-            // Handle ref command
-            printf("Ref command: %s\n", cmd.data.buf);
-            break;
-            
         case NEXTION_CMD_CLICK:
-            // Handle click command
-            printf("Click command: %s\n", cmd.data.buf);
-            break;
-            
         case NEXTION_CMD_REF_STOP:
-            // Handle ref_stop command
-            printf("Ref stop command: %s\n", cmd.data.buf);
-            break;
-            
         case NEXTION_CMD_REF_STAR:
-            // Handle ref_star command
-            printf("Ref star command: %s\n", cmd.data.buf);
+        case NEXTION_CMD_SENDME:
+        case NEXTION_CMD_COVX:
+            // Not used by the controller
+            NEXTION_LOG("Ignored command: %s\n", cmd_str);
             break;
-            
+
         case NEXTION_CMD_GET:
             // Handle get command
-            printf("Get command: %s\n", cmd.data.get.path);
+            NEXTION_LOG("Get command: %s\n", cmd.data.get.path.str);
             // if the command is "modeSelect", send 0x88, 0xFF, 0xFF, 0xFF
-            if (strncmp(cmd.data.get.path, "modeSelect", strlen("modeSelect")) == 0) {
+            if (strncmp(cmd.data.get.path.str, "modeSelect", strlen("modeSelect")) == 0) {
                 uint8_t get_cmd[] = {0x88, 0xFF, 0xFF, 0xFF};
                 serial_write(get_cmd, sizeof(get_cmd));
             }
             break;
-            
-        case NEXTION_CMD_SENDME:
-            // Handle sendme command
-            printf("Sendme command: %s\n", cmd.data.buf);
-            break;
-            
-        case NEXTION_CMD_COVX:
-            // Handle covx command
-            printf("Covx command: %s\n", cmd.data.buf);
-            break;
 
         case NEXTION_CMD_TEXT_ASSIGN:
-            // Handle text assign command
-            printf("Text assign command: %s = %s\n", cmd.data.text_assign.object, cmd.data.text_assign.value);
-            // update the text of the object
-            lv_gaggiuino_update_text(cmd.data.text_assign.object, cmd.data.text_assign.value);
+            // Handle text assign command, the value goes from the receive buffer to the model in one copy
+            NEXTION_LOG("Text assign command: %.*s = %.*s\n",
+                        (int)cmd.data.text_assign.object.len, cmd.data.text_assign.object.str,
+                        (int)cmd.data.text_assign.value.len, cmd.data.text_assign.value.str);
+            name = name_of(cmd.data.text_assign.object);
+            if (name != NULL) {
+                lv_gaggiuino_update_text(name, cmd.data.text_assign.value.str, cmd.data.text_assign.value.len);
+            }
             break;
 
         case NEXTION_CMD_VALUE_ASSIGN:
             // Handle value assign command
-            printf("Value assign command: %s = %d\n", cmd.data.value_assign.object, cmd.data.value_assign.value);
+            NEXTION_LOG("Value assign command: %.*s = %d\n", (int)cmd.data.value_assign.object.len,
+                        cmd.data.value_assign.object.str, cmd.data.value_assign.value);
+            name = name_of(cmd.data.value_assign.object);
+            if (name != NULL) lv_gaggiuino_update_value(name, cmd.data.value_assign.value);
             break;
 
         case NEXTION_CMD_VAR_ASSIGN:
             // Handle var assign command
-            printf("Var assign command: %s = %d\n", cmd.data.var_assign.name, cmd.data.var_assign.value);
+            NEXTION_LOG("Var assign command: %.*s = %d\n", (int)cmd.data.var_assign.name.len,
+                        cmd.data.var_assign.name.str, cmd.data.var_assign.value);
+            name = name_of(cmd.data.var_assign.name);
+            if (name != NULL) lv_gaggiuino_update_value(name, cmd.data.var_assign.value);
+            break;
+
+        case NEXTION_CMD_DEBUG:
+            // Handle debug command, the subject ends the message
+            if (strcmp(cmd.data.debug.what.str, "heap") == 0) {
+                lv_gaggiuino_print_page_heap();
+            }
             break;
 
         default:
         case NEXTION_CMD_UNKNOWN:
-            printf("Unknown command: %s\n", cmd_str);
+            NEXTION_LOG("Unknown command: %s\n", cmd_str);
             // check if this a known UI element, e.g. popupMSG
             if (strncmp(cmd_str, "popupMSG", strlen("popupMSG")) == 0) {
-                printf("PopupMSG command: %s\n", cmd.data.buf);
+                NEXTION_LOG("PopupMSG command: %s\n", cmd_str);
                 lv_gaggiuino_show_popup();
             }
             break;
     }
-}
\ No newline at end of file
+
+    // The names cut out of this message aren't needed anymore
+    frame_arena_reset();
+}
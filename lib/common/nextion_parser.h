@@ -8,10 +8,19 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 // Maximum size of the message buffer
 #define NEXTION_MAX_MESSAGE_SIZE 256
 
+// Set to 1 to print every message and command. Off by default: printf on every message is slow
+// on the ESP32 console and may allocate, the protocol loop must not touch the heap.
+#ifndef NEXTION_DEBUG
+#define NEXTION_DEBUG 0
+#endif
+
+#define NEXTION_LOG(...) do { if (NEXTION_DEBUG) printf(__VA_ARGS__); } while (0)
+
 // Message types
 typedef enum {
     NEXTION_MSG_TYPE_TOUCH_EVENT,
@@ -35,6 +44,7 @@ typedef enum {
     NEXTION_CMD_TEXT_ASSIGN,
     NEXTION_CMD_VALUE_ASSIGN,
     NEXTION_CMD_VAR_ASSIGN,
+    NEXTION_CMD_DEBUG,      // "dbg <what>", typed on the serial console, never sent by the controller
 } nextion_cmd_type_t;
 
 // Message structure
@@ -52,16 +62,23 @@ typedef struct {
     uint8_t ff_count;  // Count of consecutive 0xFF bytes
 } nextion_parser_t;
 
-// Command structure (union)
+// Part of a command string, not zero terminated
+typedef struct {
+    const char* str;
+    uint16_t len;
+} nextion_str_t;
+
+// Command structure (union). The strings point into the parsed command, nothing is copied
+// or truncated, so they are valid as long as the command string is.
 typedef struct {
     nextion_cmd_type_t type;
     union {
-        struct { char path[64]; } get;
-        struct { char page[32]; } page;
-        struct { char object[64]; char value[128]; } text_assign;
-        struct { char object[64]; int value; } value_assign;
-        struct { char name[64]; int value; } var_assign;
-        char buf[128];
+        struct { nextion_str_t path; } get;
+        struct { nextion_str_t page; } page;
+        struct { nextion_str_t what; } debug;
+        struct { nextion_str_t object; nextion_str_t value; } text_assign;
+        struct { nextion_str_t object; int value; } value_assign;
+        struct { nextion_str_t name; int value; } var_assign;
     } data;
 } nextion_cmd_t;
 
@@ -0,0 +1,268 @@
+/**
+ * @file obj_census.c
+ * Count of the live LVGL objects by class and by the page they belong to, to find leaks
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "obj_census.h"
+#include "metrics.h"
+#include "shot_chart.h"
+#include "gauge.h"
+#include "readout.h"
+#include "vlist.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define METRIC_NAME_MAX 40
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const lv_obj_class_t * class_p;
+    const char * name;
+} class_name_t;
+
+typedef struct {
+    const char * key;       // Group or class name
+    char name[METRIC_NAME_MAX];
+    uint32_t * value;
+} census_metric_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void count_tree(obj_census_t * census, const lv_obj_t * obj, const char * group);
+static void count_obj(obj_census_t * census, const lv_obj_t * obj, const char * group);
+static uint32_t count_local_props(const lv_obj_t * obj);
+static bool is_layout_prop(lv_style_prop_t prop);
+static uint32_t * get_metric(census_metric_t * metrics, const char * prefix, const char * key);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const class_name_t class_names[] = {
+    {&lv_label_class, "label"},
+    {&lv_btn_class, "btn"},
+    {&lv_img_class, "img"},
+    {&lv_meter_class, "meter"},
+    {&lv_chart_class, "chart"},
+    {&lv_tabview_class, "tabview"},
+    {&lv_list_class, "list"},
+    {&lv_list_btn_class, "list_btn"},
+    {&lv_list_text_class, "list_text"},
+    {&lv_btnmatrix_class, "btnmatrix"},
+    {&shot_chart_class, "shot_chart"},
+    {&gauge_class, "gauge"},
+    {&readout_class, "readout"},
+    {&vlist_class, "vlist"},
+    {&lv_obj_class, "obj"},
+};
+
+static obj_census_group_cb_t group_cb;
+
+// Names of the published metrics, they must outlive the registry
+static census_metric_t group_metrics[OBJ_CENSUS_MAX_NAMES];
+static census_metric_t class_metrics[OBJ_CENSUS_MAX_NAMES];
+static uint32_t * metric_total;
+static uint32_t * metric_local_props;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void count_tree(obj_census_t * census, const lv_obj_t * obj, const char * group)
+{
+    const char * own_group = group_cb ? group_cb(obj) : NULL;
+    if (own_group) group = own_group;
+
+    count_obj(census, obj, group);
+
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        count_tree(census, lv_obj_get_child(obj, i), group);
+    }
+}
+
+static void count_obj(obj_census_t * census, const lv_obj_t * obj, const char * group)
+{
+    const lv_obj_class_t * class_p = obj->class_p;
+    uint32_t local_props = count_local_props(obj);
+    census->total++;
+    census->local_props += local_props;
+
+    for (uint16_t i = 0; i < census->entry_cnt; i++) {
+        obj_census_entry_t * entry = &census->entries[i];
+        if (entry->class_p == class_p && strcmp(entry->group, group) == 0) {
+            entry->count++;
+            entry->local_props += local_props;
+            return;
+        }
+    }
+
+    if (census->entry_cnt == OBJ_CENSUS_MAX_ENTRIES) {
+        census->uncounted++;
+        return;
+    }
+
+    obj_census_entry_t * entry = &census->entries[census->entry_cnt++];
+    entry->class_p = class_p;
+    entry->group = group;
+    entry->count = 1;
+    entry->local_props = local_props;
+}
+
+/* Count the properties of the local styles of an object, besides the ones of is_layout_prop() */
+static uint32_t count_local_props(const lv_obj_t * obj)
+{
+    uint32_t props = 0;
+
+    for (uint32_t i = 0; i < obj->style_cnt; i++) {
+        const _lv_obj_style_t * s = &obj->styles[i];
+        if (!s->is_local) continue;
+
+        for (lv_style_prop_t prop = 1; prop <= _LV_STYLE_LAST_BUILT_IN_PROP; prop++) {
+            lv_style_value_t value;
+            if (!is_layout_prop(prop) && lv_style_get_prop(s->style, prop, &value) == LV_STYLE_RES_FOUND) {
+                props++;
+            }
+        }
+    }
+    return props;
+}
+
+/* Position, size and layout, set as local style by lv_obj_set_pos(), lv_obj_set_size(), lv_obj_align(), ... */
+static bool is_layout_prop(lv_style_prop_t prop)
+{
+    switch (prop) {
+        case LV_STYLE_X:
+        case LV_STYLE_Y:
+        case LV_STYLE_WIDTH:
+        case LV_STYLE_MIN_WIDTH:
+        case LV_STYLE_MAX_WIDTH:
+        case LV_STYLE_HEIGHT:
+        case LV_STYLE_MIN_HEIGHT:
+        case LV_STYLE_MAX_HEIGHT:
+        case LV_STYLE_ALIGN:
+        case LV_STYLE_LAYOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Get the metric of a group or class, registering it on first use. NULL if all slots are taken. */
+static uint32_t * get_metric(census_metric_t * metrics, const char * prefix, const char * key)
+{
+    for (int i = 0; i < OBJ_CENSUS_MAX_NAMES; i++) {
+        census_metric_t * m = &metrics[i];
+        if (m->key == NULL) {
+            m->key = key;
+            snprintf(m->name, sizeof(m->name), "census.%s.%s", prefix, key);
+            m->value = metrics_get(m->name);
+            return m->value;
+        }
+        if (strcmp(m->key, key) == 0) return m->value;
+    }
+    return NULL;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void obj_census_set_group_cb(obj_census_group_cb_t cb)
+{
+    group_cb = cb;
+}
+
+void obj_census_take(lv_disp_t * disp, obj_census_t * census)
+{
+    memset(census, 0, sizeof(*census));
+
+    for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+        count_tree(census, disp->screens[i], OBJ_CENSUS_ROOT_GROUP);
+    }
+    count_tree(census, disp->top_layer, "top_layer");
+    count_tree(census, disp->sys_layer, "sys_layer");
+}
+
+uint32_t obj_census_diff(const obj_census_t * before, const obj_census_t * after)
+{
+    uint32_t gained = 0;
+
+    for (uint16_t i = 0; i < after->entry_cnt; i++) {
+        const obj_census_entry_t * a = &after->entries[i];
+        uint32_t prev = 0;
+        for (uint16_t j = 0; j < before->entry_cnt; j++) {
+            const obj_census_entry_t * b = &before->entries[j];
+            if (b->class_p == a->class_p && strcmp(b->group, a->group) == 0) {
+                prev = b->count;
+                break;
+            }
+        }
+
+        if (a->count > prev) {
+            printf("census.grew %s.%s %u -> %u\n", a->group, obj_census_get_class_name(a->class_p),
+                   (unsigned)prev, (unsigned)a->count);
+            gained += a->count - prev;
+        }
+    }
+
+    // Pairs that didn't fit are only seen in the total
+    if (after->uncounted > before->uncounted) {
+        printf("census.grew uncounted %u -> %u\n", (unsigned)before->uncounted, (unsigned)after->uncounted);
+        gained += after->uncounted - before->uncounted;
+    }
+
+    return gained;
+}
+
+uint32_t obj_census_print_local_styles(const obj_census_t * census)
+{
+    for (uint16_t i = 0; i < census->entry_cnt; i++) {
+        const obj_census_entry_t * entry = &census->entries[i];
+        if (entry->local_props > 0) {
+            printf("style.local %s.%s %u\n", entry->group, obj_census_get_class_name(entry->class_p),
+                   (unsigned)entry->local_props);
+        }
+    }
+    return census->local_props;
+}
+
+void obj_census_publish(const obj_census_t * census)
+{
+    if (metric_total == NULL) {
+        metric_total = metrics_get("census.total");
+        metric_local_props = metrics_get("census.local_props");
+    }
+    *metric_total = census->total;
+    *metric_local_props = census->local_props;
+
+    // Groups and classes gone since the last census are reported as 0
+    for (int i = 0; i < OBJ_CENSUS_MAX_NAMES; i++) {
+        if (group_metrics[i].value) *group_metrics[i].value = 0;
+        if (class_metrics[i].value) *class_metrics[i].value = 0;
+    }
+
+    for (uint16_t i = 0; i < census->entry_cnt; i++) {
+        const obj_census_entry_t * entry = &census->entries[i];
+        uint32_t * group = get_metric(group_metrics, "group", entry->group);
+        uint32_t * cls = get_metric(class_metrics, "class", obj_census_get_class_name(entry->class_p));
+        if (group) *group += entry->count;
+        if (cls) *cls += entry->count;
+    }
+}
+
+const char * obj_census_get_class_name(const lv_obj_class_t * class_p)
+{
+    for (size_t i = 0; i < sizeof(class_names) / sizeof(class_names[0]); i++) {
+        if (class_names[i].class_p == class_p) return class_names[i].name;
+    }
+    return "widget";
+}
@@ -0,0 +1,102 @@
+/**
+ * @file obj_census.h
+ * Count of the live LVGL objects by class and by the page they belong to, to find leaks
+ */
+
+#ifndef OBJ_CENSUS_H
+#define OBJ_CENSUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define OBJ_CENSUS_MAX_ENTRIES  64      // Class and group pairs counted separately
+#define OBJ_CENSUS_MAX_NAMES    24      // Classes and groups published to the metrics
+#define OBJ_CENSUS_ROOT_GROUP   "screen"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Return the group of an object and its children, e.g. a page name with static storage,
+ * or NULL to keep the parent's */
+typedef const char * (*obj_census_group_cb_t)(const lv_obj_t * obj);
+
+typedef struct {
+    const lv_obj_class_t * class_p;
+    const char * group;
+    uint32_t count;
+    uint32_t local_props;   // Local style properties of these objects, see obj_census_print_local_styles()
+} obj_census_entry_t;
+
+typedef struct {
+    obj_census_entry_t entries[OBJ_CENSUS_MAX_ENTRIES];
+    uint16_t entry_cnt;
+    uint32_t total;
+    uint32_t uncounted;     // Objects of pairs that didn't fit in `entries`, still in `total`
+    uint32_t local_props;   // Local style properties of all objects
+} obj_census_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set how objects are grouped, every object is in OBJ_CENSUS_ROOT_GROUP otherwise
+ * @param group_cb the grouping function or NULL
+ */
+void obj_census_set_group_cb(obj_census_group_cb_t group_cb);
+
+/**
+ * Count the objects of every screen and of the top and system layers of a display
+ * @param disp the display
+ * @param census store the counts here
+ */
+void obj_census_take(lv_disp_t * disp, obj_census_t * census);
+
+/**
+ * Compare two censuses and print a `census.grew <group>.<class> <before> -> <after>` line for
+ * every pair with more objects in the second one
+ * @param before the earlier census
+ * @param after the later census
+ * @return number of objects gained, 0 if no pair grew
+ */
+uint32_t obj_census_diff(const obj_census_t * before, const obj_census_t * after);
+
+/**
+ * Print a `style.local <group>.<class> <properties>` line for every pair whose objects have
+ * local style properties. Position, size and layout are not counted, LVGL sets them locally
+ * itself; everything else belongs in a shared style (ui_styles.h).
+ * @param census the counts
+ * @return number of local style properties, 0 if there are none
+ */
+uint32_t obj_census_print_local_styles(const obj_census_t * census);
+
+/**
+ * Publish the counts per group and per class as `census.group.<group>` and
+ * `census.class.<class>` metrics, the total as `census.total` and the local style properties
+ * as `census.local_props`
+ * @param census the counts
+ */
+void obj_census_publish(const obj_census_t * census);
+
+/**
+ * Get the name of an object class
+ * @param class_p the class
+ * @return e.g. "label", "widget" for classes without a name
+ */
+const char * obj_census_get_class_name(const lv_obj_class_t * class_p);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*OBJ_CENSUS_H*/
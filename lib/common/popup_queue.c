@@ -0,0 +1,146 @@
+/**
+ * @file popup_queue.c
+ * Queue of popup messages with deduplication, burst coalescing and a minimum display time
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "popup_queue.h"
+#include "ui_text.h"
+#include "metrics.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void update_metrics(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+// Waiting messages, a ring starting at `head`. Short messages are stored inline, long ones in the heap.
+static ui_text_t waiting[POPUP_QUEUE_DEPTH];
+static uint32_t head;
+static uint32_t count;
+static uint32_t last_push_ms;      // Last message queued or coalesced, duplicates don't extend a burst
+
+static ui_text_t shown_text;   // Swapped with the waiting message it shows, not copied
+static bool shown;
+static bool dismissed;      // Closed, the popup is hidden on the next transition
+static uint32_t shown_since;
+
+static popup_queue_stats_t stats;
+
+static uint32_t * metric_depth;
+static uint32_t * metric_pushed;
+static uint32_t * metric_duplicates;
+static uint32_t * metric_coalesced;
+static uint32_t * metric_dropped;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void update_metrics(void)
+{
+    if (metric_depth == NULL) {
+        metric_depth = metrics_get("popup.depth");
+        metric_pushed = metrics_get("popup.pushed");
+        metric_duplicates = metrics_get("popup.duplicates");
+        metric_coalesced = metrics_get("popup.coalesced");
+        metric_dropped = metrics_get("popup.dropped");
+    }
+    *metric_depth = count;
+    *metric_pushed = stats.pushed;
+    *metric_duplicates = stats.duplicates;
+    *metric_coalesced = stats.coalesced;
+    *metric_dropped = stats.dropped;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void popup_queue_push(const char * text, uint32_t now_ms)
+{
+    stats.pushed++;
+
+    // A message equal to the shown or a waiting one adds nothing
+    size_t len = strlen(text);
+    bool duplicate = shown && !dismissed && ui_text_equals(&shown_text, text, len);
+    for (uint32_t i = 0; i < count && !duplicate; i++) {
+        duplicate = ui_text_equals(&waiting[(head + i) % POPUP_QUEUE_DEPTH], text, len);
+    }
+
+    if (duplicate) {
+        stats.duplicates++;
+    }
+    else if (count > 0 && now_ms - last_push_ms < POPUP_QUEUE_COALESCE) {
+        // Part of a burst, only its last message is worth showing
+        ui_text_set(&waiting[(head + count - 1) % POPUP_QUEUE_DEPTH], text, len);
+        stats.coalesced++;
+        last_push_ms = now_ms;
+    }
+    else {
+        if (count == POPUP_QUEUE_DEPTH) {
+            head = (head + 1) % POPUP_QUEUE_DEPTH;
+            count--;
+            stats.dropped++;
+        }
+        ui_text_set(&waiting[(head + count) % POPUP_QUEUE_DEPTH], text, len);
+        count++;
+        if (count > stats.max_depth) stats.max_depth = count;
+        last_push_ms = now_ms;
+    }
+
+    update_metrics();
+}
+
+void popup_queue_dismiss(void)
+{
+    if (shown) dismissed = true;
+}
+
+popup_queue_transition_t popup_queue_next(uint32_t now_ms)
+{
+    if (count > 0 && (!shown || dismissed || now_ms - shown_since >= POPUP_QUEUE_MIN_SHOW)) {
+        ui_text_swap(&shown_text, &waiting[head]);
+        head = (head + 1) % POPUP_QUEUE_DEPTH;
+        count--;
+        shown = true;
+        dismissed = false;
+        shown_since = now_ms;
+        stats.shown++;
+        update_metrics();
+        return POPUP_QUEUE_SHOW;
+    }
+
+    if (dismissed) {
+        shown = false;
+        dismissed = false;
+        return POPUP_QUEUE_HIDE;
+    }
+
+    return POPUP_QUEUE_NONE;
+}
+
+const char * popup_queue_get_text(void)
+{
+    return shown ? ui_text_get(&shown_text) : NULL;
+}
+
+bool popup_queue_is_pending(void)
+{
+    return count > 0 || dismissed;
+}
+
+uint32_t popup_queue_get_depth(void)
+{
+    return count;
+}
+
+void popup_queue_get_stats(popup_queue_stats_t * out)
+{
+    *out = stats;
+}
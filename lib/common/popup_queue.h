@@ -0,0 +1,93 @@
+/**
+ * @file popup_queue.h
+ * Queue of popup messages with deduplication, burst coalescing and a minimum display time
+ */
+
+#ifndef POPUP_QUEUE_H
+#define POPUP_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define POPUP_QUEUE_DEPTH       4       // Messages waiting behind the shown one
+#define POPUP_QUEUE_MIN_SHOW    1500    // ms a message is shown before the next one replaces it
+#define POPUP_QUEUE_COALESCE    250     // ms, a message replaces a waiting one pushed this recently
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    POPUP_QUEUE_NONE,   // Nothing to change
+    POPUP_QUEUE_SHOW,   // Show the message of popup_queue_get_text()
+    POPUP_QUEUE_HIDE,   // Hide the popup
+} popup_queue_transition_t;
+
+typedef struct {
+    uint32_t pushed;        // Messages pushed
+    uint32_t shown;         // Messages shown
+    uint32_t duplicates;    // Messages equal to the shown or a waiting one
+    uint32_t coalesced;     // Waiting messages replaced by a newer one of the same burst
+    uint32_t dropped;       // Waiting messages dropped because the queue was full
+    uint32_t max_depth;     // Most messages waiting at once
+} popup_queue_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Queue a message. It's dropped if it equals the shown or a waiting message.
+ * @param text the message, copied whatever its length
+ * @param now_ms current time
+ */
+void popup_queue_push(const char * text, uint32_t now_ms);
+
+/**
+ * The shown message was closed, the next one may be shown right away
+ */
+void popup_queue_dismiss(void);
+
+/**
+ * Get the next transition, at most one per call. Call it once per frame.
+ * @param now_ms current time
+ * @return the transition to render
+ */
+popup_queue_transition_t popup_queue_next(uint32_t now_ms);
+
+/**
+ * Get the shown message. It stays valid until the next POPUP_QUEUE_SHOW, a label may show it without a copy.
+ * @return the text, NULL if no message is shown
+ */
+const char * popup_queue_get_text(void);
+
+/**
+ * Check if a transition is pending, e.g. to pause the timer calling popup_queue_next()
+ */
+bool popup_queue_is_pending(void);
+
+/**
+ * Get the number of waiting messages
+ */
+uint32_t popup_queue_get_depth(void);
+
+/**
+ * Get the queue statistics
+ * @param stats store the statistics here
+ */
+void popup_queue_get_stats(popup_queue_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*POPUP_QUEUE_H*/
@@ -0,0 +1,361 @@
+/**
+ * @file readout.c
+ * Numeric readout with fixed-width character cells that redraws only the cells that changed
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "readout.h"
+#include "glyph_atlas.h"
+#include "metrics.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &readout_class
+
+#define DEFAULT_CELLS   5
+#define UNIT_GAP        4       // Space between the cells and the unit
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_obj_t obj;
+    char text[READOUT_MAX_CELLS + 1];
+    char cell_chars[READOUT_MAX_CELLS];     // Character per cell, ' ' if empty
+    char unit[READOUT_UNIT_MAX];
+    uint8_t cells;
+    lv_coord_t cell_w;
+    lv_coord_t unit_w;
+    const glyph_atlas_t * atlas;            // Pre-rasterized glyphs of the font, NULL if none
+    bool unit_in_atlas;
+    int32_t value;                          // Last value of readout_set_value()
+    uint8_t decimals;
+    bool has_value;
+    readout_stats_t stats;
+} readout_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void readout_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void readout_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void measure(readout_t * readout);
+static void layout_cells(const readout_t * readout, const char * text, char * cell_chars);
+static lv_coord_t draw_glyph(const readout_t * readout, lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                             const lv_point_t * pos, uint32_t letter, bool center_in_cell);
+static void draw_main(lv_event_t * e);
+static void count_metrics(uint32_t updates, uint32_t skipped, uint32_t px);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t readout_class = {
+    .constructor_cb = readout_constructor,
+    .event_cb = readout_event,
+    .width_def = LV_SIZE_CONTENT,
+    .height_def = LV_SIZE_CONTENT,
+    .instance_size = sizeof(readout_t),
+    .base_class = &lv_obj_class
+};
+
+static uint32_t * metric_updates;
+static uint32_t * metric_skipped;
+static uint32_t * metric_px;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void readout_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    readout_t * readout = (readout_t *)obj;
+
+    readout->cells = DEFAULT_CELLS;
+    memset(readout->cell_chars, ' ', sizeof(readout->cell_chars));
+
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+
+    if (metric_updates == NULL) {
+        metric_updates = metrics_get("readout.updates");
+        metric_skipped = metrics_get("readout.skipped");
+        metric_px = metrics_get("readout.invalidated_px");
+    }
+}
+
+static void readout_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    (void)class_p;
+
+    // Call the ancestor's event handler
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) return;
+
+    lv_event_code_t code = lv_event_get_code(e);
+    readout_t * readout = (readout_t *)lv_event_get_target(e);
+
+    if (code == LV_EVENT_STYLE_CHANGED) {
+        measure(readout);
+        lv_obj_refresh_self_size(&readout->obj);
+    }
+    else if (code == LV_EVENT_GET_SELF_SIZE) {
+        lv_point_t * p = lv_event_get_param(e);
+        const lv_font_t * font = lv_obj_get_style_text_font(&readout->obj, LV_PART_MAIN);
+        lv_coord_t w = readout->cells * readout->cell_w;
+        if (readout->unit[0] != '\0') w += UNIT_GAP + readout->unit_w;
+        p->x = LV_MAX(p->x, w);
+        p->y = LV_MAX(p->y, lv_font_get_line_height(font));
+    }
+    else if (code == LV_EVENT_DRAW_MAIN) {
+        draw_main(e);
+    }
+}
+
+/**
+ * Size the cells for the widest digit, so changing digits never changes the layout
+ */
+static void measure(readout_t * readout)
+{
+    lv_obj_t * obj = &readout->obj;
+    const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+
+    lv_coord_t cell_w = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        cell_w = LV_MAX(cell_w, (lv_coord_t)lv_font_get_glyph_width(font, (uint32_t)c, 0));
+    }
+    readout->cell_w = cell_w;
+
+    readout->atlas = glyph_atlas_find(font);
+    readout->unit_in_atlas = readout->atlas != NULL && glyph_atlas_has_text(readout->atlas, readout->unit);
+
+    // Without kerning when the unit is drawn from the atlas
+    if (readout->unit_in_atlas) {
+        lv_coord_t unit_w = 0;
+        uint32_t i = 0;
+        while (readout->unit[i] != '\0') {
+            unit_w += glyph_atlas_get_glyph(readout->atlas, _lv_txt_encoded_next(readout->unit, &i))->adv_w;
+        }
+        readout->unit_w = unit_w;
+    } else {
+        lv_point_t unit_size;
+        lv_txt_get_size(&unit_size, readout->unit, font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+        readout->unit_w = unit_size.x;
+    }
+}
+
+/**
+ * Right align a text in the cells
+ */
+static void layout_cells(const readout_t * readout, const char * text, char * cell_chars)
+{
+    size_t len = strlen(text);
+    size_t pad = len < readout->cells ? readout->cells - len : 0;
+
+    memset(cell_chars, ' ', readout->cells);
+    for (size_t i = pad; i < readout->cells; i++) {
+        cell_chars[i] = text[i - pad];
+    }
+}
+
+/**
+ * Draw a letter from the atlas, or with the font if the atlas doesn't have it
+ * @param pos top left corner of the cell or of the letter
+ * @param center_in_cell true to center the letter in the cell at `pos`
+ * @return the advance of the letter
+ */
+static lv_coord_t draw_glyph(const readout_t * readout, lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                             const lv_point_t * pos, uint32_t letter, bool center_in_cell)
+{
+    const glyph_atlas_glyph_t * glyph = NULL;
+    lv_coord_t adv_w;
+    if (readout->atlas != NULL && (glyph = glyph_atlas_get_glyph(readout->atlas, letter)) != NULL) {
+        adv_w = glyph->adv_w;
+    } else {
+        adv_w = (lv_coord_t)lv_font_get_glyph_width(dsc->font, letter, 0);
+    }
+
+    lv_point_t p = *pos;
+    if (center_in_cell) p.x += (readout->cell_w - adv_w) / 2;
+
+    if (glyph == NULL || !glyph_atlas_draw(draw_ctx, readout->atlas, dsc, &p, glyph)) {
+        lv_draw_letter(draw_ctx, dsc, &p, letter);
+    }
+    return adv_w;
+}
+
+static void draw_main(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    readout_t * readout = (readout_t *)obj;
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_dsc);
+
+    lv_area_t content;
+    lv_obj_get_content_coords(obj, &content);
+
+    // One glyph per cell, centered, so a cell can be drawn on its own
+    lv_area_t cell = content;
+    for (uint8_t i = 0; i < readout->cells; i++) {
+        cell.x1 = content.x1 + i * readout->cell_w;
+        cell.x2 = cell.x1 + readout->cell_w - 1;
+
+        char c = readout->cell_chars[i];
+        if (c == ' ' || !_lv_area_is_on(&cell, draw_ctx->clip_area)) continue;
+
+        lv_point_t pos = {cell.x1, cell.y1};
+        draw_glyph(readout, draw_ctx, &label_dsc, &pos, (uint32_t)c, true);
+    }
+
+    if (readout->unit[0] != '\0') {
+        lv_area_t unit_area = content;
+        unit_area.x1 = content.x1 + readout->cells * readout->cell_w + UNIT_GAP;
+        if (!_lv_area_is_on(&unit_area, draw_ctx->clip_area)) return;
+
+        if (readout->unit_in_atlas) {
+            lv_point_t pos = {unit_area.x1, unit_area.y1};
+            uint32_t i = 0;
+            while (readout->unit[i] != '\0') {
+                uint32_t letter = _lv_txt_encoded_next(readout->unit, &i);
+                pos.x += draw_glyph(readout, draw_ctx, &label_dsc, &pos, letter, false) + label_dsc.letter_space;
+            }
+        } else {
+            lv_draw_label(draw_ctx, &label_dsc, &unit_area, readout->unit, NULL);
+        }
+    }
+}
+
+static void count_metrics(uint32_t updates, uint32_t skipped, uint32_t px)
+{
+    *metric_updates += updates;
+    *metric_skipped += skipped;
+    *metric_px += px;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * readout_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void readout_set_cells(lv_obj_t * obj, uint8_t cells)
+{
+    readout_t * readout = (readout_t *)obj;
+    cells = LV_CLAMP(1, cells, READOUT_MAX_CELLS);
+    if (cells == readout->cells) return;
+
+    readout->cells = cells;
+    layout_cells(readout, readout->text, readout->cell_chars);
+    lv_obj_refresh_self_size(obj);
+    lv_obj_invalidate(obj);
+}
+
+void readout_set_unit(lv_obj_t * obj, const char * unit)
+{
+    readout_t * readout = (readout_t *)obj;
+
+    readout->unit[0] = '\0';
+    if (unit != NULL) {
+        strncpy(readout->unit, unit, READOUT_UNIT_MAX - 1);
+        readout->unit[READOUT_UNIT_MAX - 1] = '\0';
+    }
+    measure(readout);
+    lv_obj_refresh_self_size(obj);
+    lv_obj_invalidate(obj);
+}
+
+bool readout_set_text(lv_obj_t * obj, const char * text)
+{
+    readout_t * readout = (readout_t *)obj;
+    readout->has_value = false;
+
+    if (strncmp(readout->text, text, READOUT_MAX_CELLS) == 0) {
+        readout->stats.skipped++;
+        count_metrics(0, 1, 0);
+        return false;
+    }
+
+    strncpy(readout->text, text, READOUT_MAX_CELLS);
+    readout->text[READOUT_MAX_CELLS] = '\0';
+
+    char cell_chars[READOUT_MAX_CELLS];
+    layout_cells(readout, readout->text, cell_chars);
+
+    // Invalidate every run of changed cells
+    lv_area_t content;
+    lv_obj_get_content_coords(obj, &content);
+    uint32_t px = 0;
+    uint8_t i = 0;
+    while (i < readout->cells) {
+        if (cell_chars[i] == readout->cell_chars[i]) {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        while (i < readout->cells && cell_chars[i] != readout->cell_chars[i]) i++;
+
+        lv_area_t run = content;
+        run.x1 = content.x1 + start * readout->cell_w;
+        run.x2 = content.x1 + i * readout->cell_w - 1;
+        lv_obj_invalidate_area(obj, &run);
+        px += lv_area_get_size(&run);
+    }
+    memcpy(readout->cell_chars, cell_chars, readout->cells);
+
+    readout->stats.updates++;
+    readout->stats.invalidated_px += px;
+    count_metrics(1, 0, px);
+    return true;
+}
+
+bool readout_set_value(lv_obj_t * obj, int32_t value, uint8_t decimals)
+{
+    readout_t * readout = (readout_t *)obj;
+
+    if (readout->has_value && readout->value == value && readout->decimals == decimals) {
+        readout->stats.skipped++;
+        count_metrics(0, 1, 0);
+        return false;
+    }
+
+    char buf[READOUT_MAX_CELLS + 1];
+    if (decimals == 0) {
+        lv_snprintf(buf, sizeof(buf), "%d", (int)value);
+    } else {
+        int32_t div = 1;
+        for (uint8_t i = 0; i < decimals; i++) div *= 10;
+        int32_t abs_value = LV_ABS(value);
+        lv_snprintf(buf, sizeof(buf), "%s%d.%0*d", value < 0 ? "-" : "",
+                    (int)(abs_value / div), (int)decimals, (int)(abs_value % div));
+    }
+
+    bool changed = readout_set_text(obj, buf);
+    readout->value = value;
+    readout->decimals = decimals;
+    readout->has_value = true;
+    return changed;
+}
+
+const char * readout_get_text(const lv_obj_t * obj)
+{
+    const readout_t * readout = (const readout_t *)obj;
+    return readout->text;
+}
+
+void readout_get_stats(const lv_obj_t * obj, readout_stats_t * stats)
+{
+    const readout_t * readout = (const readout_t *)obj;
+    *stats = readout->stats;
+}
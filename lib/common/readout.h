@@ -0,0 +1,97 @@
+/**
+ * @file readout.h
+ * Numeric readout with fixed-width character cells that redraws only the cells that changed
+ */
+
+#ifndef READOUT_H
+#define READOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define READOUT_MAX_CELLS   12
+#define READOUT_UNIT_MAX    8       // Including the terminating zero
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t updates;           // Texts that changed at least one cell
+    uint32_t skipped;           // Texts or values equal to the shown one
+    uint32_t invalidated_px;    // Pixels invalidated by updates
+} readout_stats_t;
+
+extern const lv_obj_class_t readout_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a readout. The text is right aligned in cells as wide as the widest digit of the
+ * font, followed by an optional unit, so the size never depends on the value.
+ * @param parent pointer to an object, it will be the parent of the new readout
+ * @return pointer to the created readout
+ */
+lv_obj_t * readout_create(lv_obj_t * parent);
+
+/**
+ * Set the number of character cells
+ * @param obj pointer to a readout object
+ * @param cells 1 .. READOUT_MAX_CELLS, longer texts are cut at the end
+ */
+void readout_set_cells(lv_obj_t * obj, uint8_t cells);
+
+/**
+ * Set the unit shown after the cells
+ * @param obj pointer to a readout object
+ * @param unit the unit, e.g. "bar", copied. NULL or "" for none.
+ */
+void readout_set_unit(lv_obj_t * obj, const char * unit);
+
+/**
+ * Show a text. Nothing happens if it is equal to the shown one, otherwise only the cells
+ * whose character changed are invalidated.
+ * @param obj pointer to a readout object
+ * @param text the new text
+ * @return true if the text changed
+ */
+bool readout_set_text(lv_obj_t * obj, const char * text);
+
+/**
+ * Show a fixed point value, e.g. 93 with 1 decimal as "9.3". An unchanged value is skipped
+ * without formatting it.
+ * @param obj pointer to a readout object
+ * @param value the value in 1/10^decimals units
+ * @param decimals digits after the decimal point
+ * @return true if the text changed
+ */
+bool readout_set_value(lv_obj_t * obj, int32_t value, uint8_t decimals);
+
+/**
+ * Get the shown text
+ * @param obj pointer to a readout object
+ */
+const char * readout_get_text(const lv_obj_t * obj);
+
+/**
+ * Get the update statistics of a readout
+ * @param obj pointer to a readout object
+ * @param stats store the statistics here
+ */
+void readout_get_stats(const lv_obj_t * obj, readout_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*READOUT_H*/
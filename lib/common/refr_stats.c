@@ -0,0 +1,200 @@
+/**
+ * @file refr_stats.c
+ * Per-frame redraw statistics and invalidated area tracking
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "refr_stats.h"
+#include "ui_bench.h"
+#include "obj_census.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MARK_OPA_START  LV_OPA_60
+#define OWNERS_STR_MAX  512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_area_t area;
+    uint32_t time;      // lv_tick_get() when the area was redrawn
+} mark_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void stats_render_start_cb(lv_disp_drv_t * drv);
+static void stats_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static lv_obj_t * find_layer_owner(lv_obj_t * layer, const lv_area_t * area);
+static lv_obj_t * find_owner(lv_obj_t * obj, const lv_area_t * area);
+static const char * obj_name(const lv_obj_t * obj);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_t * stats_disp;
+static FILE * csv_file;
+static refr_stats_name_cb_t name_cb;
+static void (*prev_render_start_cb)(lv_disp_drv_t *);
+static void (*prev_monitor_cb)(lv_disp_drv_t *, uint32_t, uint32_t);
+
+static mark_entry_t marks[REFR_STATS_MAX_MARKS];
+static uint32_t mark_next;
+
+static uint32_t frame_cnt;
+static uint32_t frame_start_us;
+static uint32_t frame_areas;
+static uint32_t frame_area_px;
+static char frame_owners[OWNERS_STR_MAX];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Called when the invalidated areas of a frame are final and rendering starts */
+static void stats_render_start_cb(lv_disp_drv_t * drv)
+{
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    uint32_t now = lv_tick_get();
+    size_t len = 0;
+
+    frame_start_us = ui_bench_time_us();
+    frame_areas = 0;
+    frame_area_px = 0;
+    frame_owners[0] = '\0';
+
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i]) continue;
+        const lv_area_t * area = &disp->inv_areas[i];
+
+        frame_areas++;
+        frame_area_px += lv_area_get_size(area);
+
+        mark_entry_t * mark = &marks[mark_next];
+        mark->area = *area;
+        mark->time = now;
+        mark_next = (mark_next + 1) % REFR_STATS_MAX_MARKS;
+
+        if (csv_file == NULL || len >= sizeof(frame_owners) - 1) continue;
+
+        // Screens and layers cover the whole display, only their children can own an area
+        lv_obj_t * owner = find_layer_owner(lv_disp_get_scr_act(disp), area);
+        if (owner == NULL) owner = find_layer_owner(lv_disp_get_layer_top(disp), area);
+        if (owner == NULL) owner = find_layer_owner(lv_disp_get_layer_sys(disp), area);
+
+        int n = snprintf(&frame_owners[len], sizeof(frame_owners) - len, "%s%s:%dx%d@%d,%d",
+                         len ? " " : "", owner ? obj_name(owner) : "screen",
+                         (int)lv_area_get_width(area), (int)lv_area_get_height(area),
+                         (int)area->x1, (int)area->y1);
+        if (n > 0) len = LV_MIN(len + (size_t)n, sizeof(frame_owners) - 1);
+    }
+
+    if (prev_render_start_cb) prev_render_start_cb(drv);
+}
+
+/* Called after a frame was rendered and flushed */
+static void stats_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    uint32_t render_us = ui_bench_time_us() - frame_start_us;
+
+    if (csv_file) {
+        fprintf(csv_file, "%u,%u,%u,%u,%u,%u,\"%s\"\n",
+                frame_cnt, lv_tick_get(), frame_areas, frame_area_px, px, render_us, frame_owners);
+        fflush(csv_file);
+    }
+    frame_cnt++;
+
+    if (prev_monitor_cb) prev_monitor_cb(drv, time, px);
+}
+
+/* Find the owner of `area` among the children of a screen or layer, topmost child first */
+static lv_obj_t * find_layer_owner(lv_obj_t * layer, const lv_area_t * area)
+{
+    if (layer == NULL || lv_obj_has_flag(layer, LV_OBJ_FLAG_HIDDEN)) return NULL;
+
+    for (int32_t i = (int32_t)lv_obj_get_child_cnt(layer) - 1; i >= 0; i--) {
+        lv_obj_t * owner = find_owner(lv_obj_get_child(layer, i), area);
+        if (owner) return owner;
+    }
+    return NULL;
+}
+
+/* Find the deepest visible object which fully contains `area`, topmost child first */
+static lv_obj_t * find_owner(lv_obj_t * obj, const lv_area_t * area)
+{
+    if (obj == NULL || lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return NULL;
+    if (!_lv_area_is_in(area, &obj->coords, 0)) return NULL;
+
+    for (int32_t i = (int32_t)lv_obj_get_child_cnt(obj) - 1; i >= 0; i--) {
+        lv_obj_t * owner = find_owner(lv_obj_get_child(obj, i), area);
+        if (owner) return owner;
+    }
+    return obj;
+}
+
+static const char * obj_name(const lv_obj_t * obj)
+{
+    const char * name = name_cb ? name_cb(obj) : NULL;
+    if (name) return name;
+
+    return obj_census_get_class_name(obj->class_p);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void refr_stats_init(lv_disp_t * disp, FILE * csv)
+{
+    stats_disp = disp;
+    csv_file = csv;
+    frame_cnt = 0;
+    memset(marks, 0, sizeof(marks));
+
+    prev_render_start_cb = disp->driver->render_start_cb;
+    prev_monitor_cb = disp->driver->monitor_cb;
+    disp->driver->render_start_cb = stats_render_start_cb;
+    disp->driver->monitor_cb = stats_monitor_cb;
+
+    if (csv_file) {
+        fprintf(csv_file, "frame,time_ms,areas,area_px,rendered_px,render_us,objects\n");
+    }
+}
+
+void refr_stats_deinit(void)
+{
+    if (stats_disp == NULL) return;
+
+    stats_disp->driver->render_start_cb = prev_render_start_cb;
+    stats_disp->driver->monitor_cb = prev_monitor_cb;
+    stats_disp = NULL;
+    csv_file = NULL;
+}
+
+void refr_stats_set_name_cb(refr_stats_name_cb_t cb)
+{
+    name_cb = cb;
+}
+
+uint32_t refr_stats_get_marks(refr_stats_mark_t * out, uint32_t max)
+{
+    uint32_t cnt = 0;
+
+    for (uint32_t i = 0; i < REFR_STATS_MAX_MARKS && cnt < max; i++) {
+        const mark_entry_t * mark = &marks[i];
+        if (mark->time == 0) continue;
+
+        uint32_t age = lv_tick_elaps(mark->time);
+        if (age >= REFR_STATS_FADE_TIME) continue;
+
+        out[cnt].area = mark->area;
+        out[cnt].opa = (lv_opa_t)(MARK_OPA_START * (REFR_STATS_FADE_TIME - age) / REFR_STATS_FADE_TIME);
+        cnt++;
+    }
+    return cnt;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file refr_stats.h
+ * Per-frame redraw statistics and invalidated area tracking
+ */
+
+#ifndef REFR_STATS_H
+#define REFR_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define REFR_STATS_MAX_MARKS    64      // Redrawn areas kept for the overlay
+#define REFR_STATS_FADE_TIME    600     // ms until a redrawn area fades out of the overlay
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_area_t area;
+    lv_opa_t opa;       // Tint opacity, fades from the moment the area was redrawn
+} refr_stats_mark_t;
+
+/* Return a printable name of an object or NULL if it has none */
+typedef const char * (*refr_stats_name_cb_t)(const lv_obj_t * obj);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start recording every refresh of a display.
+ * For each frame that renders something, one CSV line is written with the number of redrawn
+ * areas, the pixels they cover, the pixels actually rendered, the render time and the
+ * objects owning the areas (the deepest visible object fully containing each area).
+ * @param disp the display to watch
+ * @param csv write the statistics here, NULL to only track areas for the overlay
+ */
+void refr_stats_init(lv_disp_t * disp, FILE * csv);
+
+/**
+ * Stop recording and restore the display driver callbacks
+ */
+void refr_stats_deinit(void);
+
+/**
+ * Set how objects are named in the CSV, the object class is used otherwise
+ * @param name_cb the naming function or NULL
+ */
+void refr_stats_set_name_cb(refr_stats_name_cb_t name_cb);
+
+/**
+ * Get the recently redrawn areas with a fading tint opacity
+ * @param marks store the areas here
+ * @param max size of `marks`
+ * @return number of areas stored, 0 once all of them faded out
+ */
+uint32_t refr_stats_get_marks(refr_stats_mark_t * marks, uint32_t max);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*REFR_STATS_H*/
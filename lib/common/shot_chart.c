@@ -0,0 +1,693 @@
+/**
+ * @file shot_chart.c
+ * Shot plot widget drawing the shot series with a cached background and per-column updates
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "shot_chart.h"
+#include "mem_place.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &shot_chart_class
+
+#define LABEL_WIDTH     32      // Space for the axis labels left and right of the plot
+#define LABEL_GAP       4       // Distance between the labels and the plot
+#define GRID_DIV_X      10      // Vertical grid lines, they scroll with the samples in scroll mode
+#define GRID_DIV_Y      5       // Horizontal grid lines, one label each
+#define LINE_WIDTH      2       // Minimum height of a column span in rows
+#define MAX_INV_RUNS    8       // Changed column runs invalidated separately, more become one area
+#define MAX_COLUMNS     SHOT_SERIES_MAX_BUCKETS
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Rows covered by a channel in one column, empty if y1 > y2 */
+typedef struct {
+    int16_t y1;
+    int16_t y2;
+} span_t;
+
+typedef struct {
+    lv_color_t color;
+    shot_chart_axis_t axis;
+    bool enabled;
+} channel_t;
+
+typedef struct {
+    lv_obj_t obj;
+    channel_t ch[SHOT_CH_COUNT];
+    int32_t min[SHOT_CHART_AXIS_COUNT];
+    int32_t max[SHOT_CHART_AXIS_COUNT];
+    shot_chart_mode_t mode;
+    int16_t * target;           // Target profile, drawn into the background
+    uint16_t target_cnt;
+    lv_color_t target_color;
+    shot_chart_axis_t target_axis;
+    lv_coord_t plot_x;          // Plot area relative to the object
+    lv_coord_t plot_y;
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_color_t grid_color;
+    lv_color_t * bg_buf;        // Cached background: grid and target
+    lv_color_t * buf;           // The background with the series composed over it
+    lv_img_dsc_t img;           // `buf` as an image
+    span_t * spans;             // SHOT_CH_COUNT x w spans
+    uint32_t seen_total;        // shot_series_get_total() at the last refresh
+    uint32_t seen_generation;   // shot_series_get_generation() at the last rebuild
+    uint32_t origin;            // Scroll mode: sample number shown in the first column
+    shot_chart_stats_t stats;
+} shot_chart_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void shot_chart_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void shot_chart_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void shot_chart_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void layout(shot_chart_t * chart);
+static void free_bufs(shot_chart_t * chart);
+static void rebuild(shot_chart_t * chart);
+static void render_background(shot_chart_t * chart);
+static void compose_column(shot_chart_t * chart, lv_coord_t x);
+static void update_fit(shot_chart_t * chart);
+static bool update_scroll(shot_chart_t * chart);
+static void set_span(shot_chart_t * chart, shot_channel_t ch, lv_coord_t x, span_t span);
+static void flush_columns(shot_chart_t * chart, bool compose_all, bool invalidate_all);
+static void draw_main(lv_event_t * e);
+static lv_coord_t value_to_row(const shot_chart_t * chart, shot_chart_axis_t axis, int32_t value);
+static lv_coord_t grid_row(const shot_chart_t * chart, int32_t i);
+static span_t make_span(const shot_chart_t * chart, shot_chart_axis_t axis, int32_t min, int32_t max);
+static span_t connect_span(span_t span, span_t prev);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t shot_chart_class = {
+    .constructor_cb = shot_chart_constructor,
+    .destructor_cb = shot_chart_destructor,
+    .event_cb = shot_chart_event,
+    .width_def = LV_PCT(100),
+    .height_def = LV_PCT(100),
+    .instance_size = sizeof(shot_chart_t),
+    .base_class = &lv_obj_class
+};
+
+static const span_t span_empty = {1, 0};
+
+// Rows changed per column during a refresh, y1 > y2 if the column is unchanged
+static lv_coord_t dirty_y1[MAX_COLUMNS];
+static lv_coord_t dirty_y2[MAX_COLUMNS];
+static bool dirty_ready;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void shot_chart_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    shot_chart_t * chart = (shot_chart_t *)obj;
+
+    for (int axis = 0; axis < SHOT_CHART_AXIS_COUNT; axis++) {
+        chart->min[axis] = 0;
+        chart->max[axis] = 100 * SHOT_SERIES_SCALE;
+    }
+    chart->mode = SHOT_CHART_MODE_FIT;
+    chart->img.header.cf = LV_IMG_CF_TRUE_COLOR;
+
+    // All columns start unchanged
+    if (!dirty_ready) {
+        dirty_ready = true;
+        for (lv_coord_t x = 0; x < MAX_COLUMNS; x++) {
+            dirty_y1[x] = LV_COORD_MAX;
+            dirty_y2[x] = -LV_COORD_MAX;
+        }
+    }
+
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+}
+
+static void shot_chart_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    shot_chart_t * chart = (shot_chart_t *)obj;
+
+    free_bufs(chart);
+    if (chart->target) lv_mem_free(chart->target);
+    chart->target = NULL;
+}
+
+static void shot_chart_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    (void)class_p;
+
+    // Call the ancestor's event handler
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) return;
+
+    lv_event_code_t code = lv_event_get_code(e);
+    shot_chart_t * chart = (shot_chart_t *)lv_event_get_target(e);
+
+    if (code == LV_EVENT_SIZE_CHANGED || code == LV_EVENT_STYLE_CHANGED) {
+        layout(chart);
+    }
+    else if (code == LV_EVENT_DRAW_MAIN) {
+        draw_main(e);
+    }
+}
+
+/**
+ * Place the plot between the axis labels and (re)allocate the buffers if its size changed
+ */
+static void layout(shot_chart_t * chart)
+{
+    lv_obj_t * obj = &chart->obj;
+    lv_area_t content;
+    lv_obj_get_content_coords(obj, &content);
+
+    // Leave half a label above the top and below the bottom grid line
+    const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t half_line = lv_font_get_line_height(font) / 2;
+
+    lv_coord_t w = lv_area_get_width(&content) - 2 * LABEL_WIDTH;
+    lv_coord_t h = lv_area_get_height(&content) - 2 * half_line;
+    w = LV_CLAMP(0, w, MAX_COLUMNS);
+    h = LV_MAX(h, 0);
+
+    chart->plot_x = content.x1 - obj->coords.x1 + LABEL_WIDTH;
+    chart->plot_y = content.y1 - obj->coords.y1 + half_line;
+
+    if (w != chart->w || h != chart->h || chart->buf == NULL) {
+        free_bufs(chart);
+        if (w > 0 && h > 0) {
+            size_t px_cnt = (size_t)w * h;
+            // The composed pixels are shifted and blitted on every sample, the background is
+            // only read for the columns that changed
+            chart->bg_buf = mem_place_alloc(px_cnt * sizeof(lv_color_t), MEM_PLACE_COLD);
+            chart->buf = mem_place_alloc(px_cnt * sizeof(lv_color_t), MEM_PLACE_RENDER);
+            chart->spans = mem_place_alloc((size_t)SHOT_CH_COUNT * w * sizeof(span_t), MEM_PLACE_HOT);
+            if (chart->bg_buf == NULL || chart->buf == NULL || chart->spans == NULL) {
+                LV_LOG_WARN("shot_chart: out of memory for a %dx%d plot", (int)w, (int)h);
+                free_bufs(chart);
+                return;
+            }
+            chart->w = w;
+            chart->h = h;
+            chart->img.header.w = w;
+            chart->img.header.h = h;
+            chart->img.data_size = px_cnt * sizeof(lv_color_t);
+            chart->img.data = (const uint8_t *)chart->buf;
+        }
+    }
+
+    if (chart->buf == NULL) return;
+
+    // One bucket per column, so the whole shot fits however long it runs
+    if (chart->mode == SHOT_CHART_MODE_FIT) shot_series_set_width((uint16_t)chart->w);
+
+    rebuild(chart);
+}
+
+static void free_bufs(shot_chart_t * chart)
+{
+    // The image cache may still point to the old pixels
+    lv_img_cache_invalidate_src(&chart->img);
+
+    mem_place_free(chart->bg_buf);
+    mem_place_free(chart->buf);
+    mem_place_free(chart->spans);
+    chart->bg_buf = NULL;
+    chart->buf = NULL;
+    chart->spans = NULL;
+    chart->w = 0;
+    chart->h = 0;
+}
+
+/**
+ * Render the background and compose every column again, e.g. after a resize, a new range or
+ * a reset of the shot series
+ */
+static void rebuild(shot_chart_t * chart)
+{
+    if (chart->buf == NULL) return;
+
+    render_background(chart);
+
+    for (int32_t i = 0; i < SHOT_CH_COUNT * chart->w; i++) {
+        chart->spans[i] = span_empty;
+    }
+
+    uint32_t total = shot_series_get_total();
+    uint32_t visible = LV_MIN(shot_series_get_count(), (uint32_t)chart->w);
+    chart->origin = chart->mode == SHOT_CHART_MODE_SCROLL ? total - visible : 0;
+    chart->seen_total = 0;
+
+    if (chart->mode == SHOT_CHART_MODE_FIT) update_fit(chart);
+    else update_scroll(chart);
+
+    chart->seen_total = total;
+    chart->seen_generation = shot_series_get_generation();
+    flush_columns(chart, true, true);
+}
+
+/**
+ * Render the parts that do not depend on the samples: background color, horizontal grid
+ * lines and the target profile. The vertical grid lines are added per column.
+ */
+static void render_background(shot_chart_t * chart)
+{
+    lv_obj_t * obj = &chart->obj;
+    lv_color_t bg_color = lv_obj_get_style_bg_color(obj, LV_PART_MAIN);
+    lv_color_t text_color = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
+    chart->grid_color = lv_color_mix(text_color, bg_color, LV_OPA_20);
+
+    lv_coord_t w = chart->w;
+    for (lv_coord_t x = 0; x < w; x++) chart->bg_buf[x] = bg_color;
+    for (lv_coord_t y = 1; y < chart->h; y++) {
+        memcpy(&chart->bg_buf[y * w], chart->bg_buf, w * sizeof(lv_color_t));
+    }
+
+    for (int32_t i = 0; i <= GRID_DIV_Y; i++) {
+        lv_color_t * row = &chart->bg_buf[grid_row(chart, i) * w];
+        for (lv_coord_t x = 0; x < w; x++) row[x] = chart->grid_color;
+    }
+
+    // The target is stretched over the plot, so it would not line up with scrolling samples
+    if (chart->target == NULL || chart->mode != SHOT_CHART_MODE_FIT) return;
+
+    lv_color_t color = lv_color_mix(chart->target_color, bg_color, LV_OPA_40);
+    span_t prev = span_empty;
+    for (lv_coord_t x = 0; x < w; x++) {
+        int16_t value = chart->target[(uint32_t)x * chart->target_cnt / w];
+        span_t raw = make_span(chart, chart->target_axis, value, value);
+        span_t span = connect_span(raw, prev);
+        prev = raw;
+        for (lv_coord_t y = span.y1; y <= span.y2; y++) chart->bg_buf[y * w + x] = color;
+    }
+}
+
+/**
+ * Copy a column of the background into the composed buffer and draw the series over it
+ */
+static void compose_column(shot_chart_t * chart, lv_coord_t x)
+{
+    lv_coord_t w = chart->w;
+    lv_color_t * dst = &chart->buf[x];
+
+    uint32_t sample = chart->mode == SHOT_CHART_MODE_SCROLL ? chart->origin + x : (uint32_t)x;
+    uint32_t period = LV_MAX(1, w / GRID_DIV_X);
+    if (sample % period == 0) {
+        for (lv_coord_t y = 0; y < chart->h; y++) dst[y * w] = chart->grid_color;
+    } else {
+        const lv_color_t * src = &chart->bg_buf[x];
+        for (lv_coord_t y = 0; y < chart->h; y++) dst[y * w] = src[y * w];
+    }
+
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        if (!chart->ch[ch].enabled) continue;
+        span_t span = chart->spans[ch * w + x];
+        for (lv_coord_t y = span.y1; y <= span.y2; y++) dst[y * w] = chart->ch[ch].color;
+    }
+
+    mem_place_touch(chart->bg_buf, chart->h * sizeof(lv_color_t));
+    mem_place_touch(chart->buf, chart->h * sizeof(lv_color_t));
+    chart->stats.columns++;
+}
+
+/**
+ * Map the decimated buckets to the columns, the shot spans the whole width once it has as many
+ * samples. Buckets that did not change map to the same span: until then only the last column or
+ * two are touched, afterwards the columns touched are those whose share of the stored buckets moved.
+ */
+static void update_fit(shot_chart_t * chart)
+{
+    static shot_bucket_t buckets[MAX_COLUMNS];
+
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        if (!chart->ch[ch].enabled) continue;
+
+        uint16_t cnt = shot_series_get_buckets((shot_channel_t)ch, buckets, (uint16_t)chart->w);
+        span_t prev = span_empty;
+        for (lv_coord_t x = 0; x < chart->w; x++) {
+            span_t raw = x < cnt ? make_span(chart, chart->ch[ch].axis, buckets[x].min, buckets[x].max) : span_empty;
+            set_span(chart, (shot_channel_t)ch, x, connect_span(raw, prev));
+            prev = raw;
+        }
+    }
+}
+
+/**
+ * Show the latest samples, one per column. When they no longer fit, the composed pixels and
+ * spans are shifted to the left and only the new columns are composed.
+ * @return true if the columns were shifted
+ */
+static bool update_scroll(shot_chart_t * chart)
+{
+    lv_coord_t w = chart->w;
+    uint32_t count = shot_series_get_count();
+    uint32_t total = shot_series_get_total();
+    uint32_t visible = LV_MIN(count, (uint32_t)w);
+    uint32_t origin = total - visible;
+    uint32_t first = total - count;     // Sample number of the oldest held sample
+    bool shifted = false;
+
+    uint32_t shift = origin - chart->origin;
+    if (shift >= (uint32_t)w) {
+        // Everything scrolled out, compose all columns
+        for (int32_t i = 0; i < SHOT_CH_COUNT * w; i++) chart->spans[i] = span_empty;
+        for (lv_coord_t x = 0; x < w; x++) {
+            dirty_y1[x] = 0;
+            dirty_y2[x] = chart->h - 1;
+        }
+        chart->origin = origin;
+        chart->seen_total = origin;
+        shifted = true;
+    }
+    else if (shift > 0) {
+        lv_coord_t keep = w - (lv_coord_t)shift;
+        for (lv_coord_t y = 0; y < chart->h; y++) {
+            lv_color_t * row = &chart->buf[y * w];
+            memmove(row, row + shift, keep * sizeof(lv_color_t));
+        }
+        for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+            span_t * spans = &chart->spans[ch * w];
+            memmove(spans, spans + shift, keep * sizeof(span_t));
+            for (lv_coord_t x = keep; x < w; x++) spans[x] = span_empty;
+        }
+        chart->origin = origin;
+        chart->stats.shifts++;
+        shifted = true;
+    }
+
+    // Compose the columns of the new samples
+    uint32_t start = LV_MAX(chart->seen_total, origin) - origin;
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        if (!chart->ch[ch].enabled) continue;
+
+        shot_chart_axis_t axis = chart->ch[ch].axis;
+        span_t prev = span_empty;
+        if (start > 0) {
+            int16_t v = shot_series_get((shot_channel_t)ch, origin + start - 1 - first);
+            prev = make_span(chart, axis, v, v);
+        }
+        for (uint32_t x = start; x < (uint32_t)w; x++) {
+            span_t raw = span_empty;
+            if (x < visible) {
+                int16_t v = shot_series_get((shot_channel_t)ch, origin + x - first);
+                raw = make_span(chart, axis, v, v);
+            }
+            set_span(chart, (shot_channel_t)ch, (lv_coord_t)x, connect_span(raw, prev));
+            prev = raw;
+        }
+    }
+
+    return shifted;
+}
+
+/**
+ * Store the span of a channel in a column and mark the rows that changed
+ */
+static void set_span(shot_chart_t * chart, shot_channel_t ch, lv_coord_t x, span_t span)
+{
+    span_t * old = &chart->spans[ch * chart->w + x];
+    if (old->y1 == span.y1 && old->y2 == span.y2) return;
+
+    if (old->y1 <= old->y2) {
+        dirty_y1[x] = LV_MIN(dirty_y1[x], old->y1);
+        dirty_y2[x] = LV_MAX(dirty_y2[x], old->y2);
+    }
+    if (span.y1 <= span.y2) {
+        dirty_y1[x] = LV_MIN(dirty_y1[x], span.y1);
+        dirty_y2[x] = LV_MAX(dirty_y2[x], span.y2);
+    }
+    *old = span;
+}
+
+/**
+ * Compose the marked columns and invalidate the changed rows of each run of columns
+ * @param compose_all compose every column, not only the marked ones
+ * @param invalidate_all invalidate the whole plot
+ */
+static void flush_columns(shot_chart_t * chart, bool compose_all, bool invalidate_all)
+{
+    lv_obj_t * obj = &chart->obj;
+    lv_coord_t w = chart->w;
+    lv_coord_t ofs_x = obj->coords.x1 + chart->plot_x;
+    lv_coord_t ofs_y = obj->coords.y1 + chart->plot_y;
+
+    lv_area_t bbox = {LV_COORD_MAX, LV_COORD_MAX, -LV_COORD_MAX, -LV_COORD_MAX};
+    lv_area_t runs[MAX_INV_RUNS];
+    uint32_t run_cnt = 0;
+    bool in_run = false;
+
+    for (lv_coord_t x = 0; x < w; x++) {
+        bool dirty = dirty_y1[x] <= dirty_y2[x];
+        if (dirty || compose_all) compose_column(chart, x);
+
+        if (!dirty) {
+            in_run = false;
+            continue;
+        }
+
+        lv_area_t col = {ofs_x + x, ofs_y + dirty_y1[x], ofs_x + x, ofs_y + dirty_y2[x]};
+        _lv_area_join(&bbox, &bbox, &col);
+        if (in_run) {
+            if (run_cnt <= MAX_INV_RUNS) _lv_area_join(&runs[run_cnt - 1], &runs[run_cnt - 1], &col);
+        } else {
+            if (run_cnt < MAX_INV_RUNS) runs[run_cnt] = col;
+            run_cnt++;
+            in_run = true;
+        }
+
+        dirty_y1[x] = LV_COORD_MAX;
+        dirty_y2[x] = -LV_COORD_MAX;
+    }
+
+    if (invalidate_all) {
+        lv_area_t plot = {ofs_x, ofs_y, ofs_x + w - 1, ofs_y + chart->h - 1};
+        lv_obj_invalidate_area(obj, &plot);
+        chart->stats.invalidated_px += lv_area_get_size(&plot);
+    }
+    else if (run_cnt > MAX_INV_RUNS) {
+        lv_obj_invalidate_area(obj, &bbox);
+        chart->stats.invalidated_px += lv_area_get_size(&bbox);
+    }
+    else {
+        for (uint32_t i = 0; i < run_cnt; i++) {
+            lv_obj_invalidate_area(obj, &runs[i]);
+            chart->stats.invalidated_px += lv_area_get_size(&runs[i]);
+        }
+    }
+}
+
+static void draw_main(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    shot_chart_t * chart = (shot_chart_t *)obj;
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    if (chart->buf == NULL) return;
+
+    lv_area_t plot;
+    plot.x1 = obj->coords.x1 + chart->plot_x;
+    plot.y1 = obj->coords.y1 + chart->plot_y;
+    plot.x2 = plot.x1 + chart->w - 1;
+    plot.y2 = plot.y1 + chart->h - 1;
+
+    // A plain copy of the composed pixels, clipped to the invalidated area
+    lv_area_t copied;
+    if (_lv_area_intersect(&copied, &plot, draw_ctx->clip_area)) {
+        mem_place_touch(chart->buf, lv_area_get_size(&copied) * sizeof(lv_color_t));
+        lv_draw_img_dsc_t img_dsc;
+        lv_draw_img_dsc_init(&img_dsc);
+        lv_draw_img(draw_ctx, &img_dsc, &plot, &chart->img);
+    }
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_dsc);
+    lv_coord_t line_h = lv_font_get_line_height(label_dsc.font);
+
+    for (int axis = 0; axis < SHOT_CHART_AXIS_COUNT; axis++) {
+        lv_area_t label_area;
+        if (axis == SHOT_CHART_AXIS_PRIMARY) {
+            label_area.x1 = plot.x1 - LABEL_WIDTH;
+            label_area.x2 = plot.x1 - LABEL_GAP;
+            label_dsc.align = LV_TEXT_ALIGN_RIGHT;
+        } else {
+            label_area.x1 = plot.x2 + LABEL_GAP;
+            label_area.x2 = plot.x2 + LABEL_WIDTH;
+            label_dsc.align = LV_TEXT_ALIGN_LEFT;
+        }
+
+        for (int32_t i = 0; i <= GRID_DIV_Y; i++) {
+            label_area.y1 = plot.y1 + grid_row(chart, i) - line_h / 2;
+            label_area.y2 = label_area.y1 + line_h - 1;
+            if (!_lv_area_is_on(&label_area, draw_ctx->clip_area)) continue;
+
+            char text[16];
+            int32_t value = chart->min[axis] + (chart->max[axis] - chart->min[axis]) * i / GRID_DIV_Y;
+            lv_snprintf(text, sizeof(text), "%d", (int)(value / SHOT_SERIES_SCALE));
+            lv_draw_label(draw_ctx, &label_dsc, &label_area, text, NULL);
+        }
+    }
+}
+
+static lv_coord_t value_to_row(const shot_chart_t * chart, shot_chart_axis_t axis, int32_t value)
+{
+    int32_t range = chart->max[axis] - chart->min[axis];
+    if (range <= 0) return chart->h - 1;
+
+    int32_t row = (chart->h - 1) - (value - chart->min[axis]) * (chart->h - 1) / range;
+    return (lv_coord_t)LV_CLAMP(0, row, chart->h - 1);
+}
+
+/* Row of the i-th horizontal grid line counted from the bottom */
+static lv_coord_t grid_row(const shot_chart_t * chart, int32_t i)
+{
+    return (lv_coord_t)((chart->h - 1) - i * (chart->h - 1) / GRID_DIV_Y);
+}
+
+static span_t make_span(const shot_chart_t * chart, shot_chart_axis_t axis, int32_t min, int32_t max)
+{
+    span_t span;
+    span.y1 = value_to_row(chart, axis, max);
+    span.y2 = value_to_row(chart, axis, min);
+
+    if (span.y2 - span.y1 + 1 < LINE_WIDTH) {
+        span.y2 = (int16_t)LV_MIN(span.y1 + LINE_WIDTH - 1, chart->h - 1);
+        span.y1 = (int16_t)LV_MAX(0, span.y2 - LINE_WIDTH + 1);
+    }
+    return span;
+}
+
+/* Extend a span to reach the previous column's one, so steep segments have no gaps */
+static span_t connect_span(span_t span, span_t prev)
+{
+    if (span.y1 > span.y2 || prev.y1 > prev.y2) return span;
+
+    if (span.y1 > prev.y2) span.y1 = prev.y2;
+    if (span.y2 < prev.y1) span.y2 = prev.y1;
+    return span;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * shot_chart_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void shot_chart_set_range(lv_obj_t * obj, shot_chart_axis_t axis, int32_t min, int32_t max)
+{
+    shot_chart_t * chart = (shot_chart_t *)obj;
+    if (axis >= SHOT_CHART_AXIS_COUNT) return;
+    if (chart->min[axis] == min && chart->max[axis] == max) return;
+
+    chart->min[axis] = min;
+    chart->max[axis] = max;
+    rebuild(chart);
+    lv_obj_invalidate(obj);
+}
+
+void shot_chart_set_channel(lv_obj_t * obj, shot_channel_t ch, lv_color_t color, shot_chart_axis_t axis)
+{
+    shot_chart_t * chart = (shot_chart_t *)obj;
+    if (ch >= SHOT_CH_COUNT || axis >= SHOT_CHART_AXIS_COUNT) return;
+
+    chart->ch[ch].color = color;
+    chart->ch[ch].axis = axis;
+    chart->ch[ch].enabled = true;
+    rebuild(chart);
+}
+
+void shot_chart_set_mode(lv_obj_t * obj, shot_chart_mode_t mode)
+{
+    shot_chart_t * chart = (shot_chart_t *)obj;
+    if (chart->mode == mode) return;
+
+    chart->mode = mode;
+    if (chart->buf && mode == SHOT_CHART_MODE_FIT) shot_series_set_width((uint16_t)chart->w);
+    rebuild(chart);
+}
+
+shot_chart_mode_t shot_chart_get_mode(const lv_obj_t * obj)
+{
+    const shot_chart_t * chart = (const shot_chart_t *)obj;
+    return chart->mode;
+}
+
+void shot_chart_set_target(lv_obj_t * obj, const int16_t * values, uint16_t cnt, lv_color_t color,
+                           shot_chart_axis_t axis)
+{
+    shot_chart_t * chart = (shot_chart_t *)obj;
+
+    if (chart->target) lv_mem_free(chart->target);
+    chart->target = NULL;
+    chart->target_cnt = 0;
+
+    if (values != NULL && cnt > 0) {
+        chart->target = lv_mem_alloc(cnt * sizeof(int16_t));
+        LV_ASSERT_MALLOC(chart->target);
+        if (chart->target) {
+            memcpy(chart->target, values, cnt * sizeof(int16_t));
+            chart->target_cnt = cnt;
+        }
+    }
+    chart->target_color = color;
+    chart->target_axis = axis < SHOT_CHART_AXIS_COUNT ? axis : SHOT_CHART_AXIS_PRIMARY;
+    rebuild(chart);
+}
+
+void shot_chart_refresh(lv_obj_t * obj)
+{
+    shot_chart_t * chart = (shot_chart_t *)obj;
+    if (chart->buf == NULL) return;
+
+    // The series was reset, the new shot may already have as many samples as the shown one
+    if (shot_series_get_generation() != chart->seen_generation) {
+        rebuild(chart);
+        return;
+    }
+
+    uint32_t total = shot_series_get_total();
+    if (total == chart->seen_total) return;
+
+    chart->stats.refreshes++;
+    chart->stats.samples += total - chart->seen_total;
+
+    bool shifted;
+    if (chart->mode == SHOT_CHART_MODE_FIT) {
+        update_fit(chart);
+        shifted = false;
+    } else {
+        shifted = update_scroll(chart);
+    }
+    chart->seen_total = total;
+
+    // Shifted pixels changed everywhere, but they are only copied, not rasterized again
+    flush_columns(chart, false, shifted);
+}
+
+lv_coord_t shot_chart_get_plot_width(const lv_obj_t * obj)
+{
+    const shot_chart_t * chart = (const shot_chart_t *)obj;
+    return chart->w;
+}
+
+void shot_chart_get_stats(const lv_obj_t * obj, shot_chart_stats_t * stats)
+{
+    const shot_chart_t * chart = (const shot_chart_t *)obj;
+    *stats = chart->stats;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file shot_chart.h
+ * Shot plot widget drawing the shot series with a cached background and per-column updates
+ */
+
+#ifndef SHOT_CHART_H
+#define SHOT_CHART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+#include "shot_series.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    SHOT_CHART_MODE_FIT,        // The whole shot decimated to the plot width
+    SHOT_CHART_MODE_SCROLL,     // The latest samples, one per column, scrolling to the left
+} shot_chart_mode_t;
+
+typedef enum {
+    SHOT_CHART_AXIS_PRIMARY,    // Left axis
+    SHOT_CHART_AXIS_SECONDARY,  // Right axis
+    SHOT_CHART_AXIS_COUNT
+} shot_chart_axis_t;
+
+typedef struct {
+    uint32_t refreshes;         // Refreshes that found new samples
+    uint32_t samples;           // Samples appended
+    uint32_t columns;           // Columns composed
+    uint32_t shifts;            // Scroll steps done by shifting the composed pixels
+    uint32_t invalidated_px;    // Pixels invalidated by refreshes
+} shot_chart_stats_t;
+
+extern const lv_obj_class_t shot_chart_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a shot chart. It shows the samples of `shot_series` and, in fit mode, sets the
+ * decimation width of the series to its plot width.
+ * The background (grid and target profile) is rendered once into a cache and the series are
+ * composed over it column by column, so a new sample only redraws the pixels it changed.
+ * @param parent pointer to an object, it will be the parent of the new chart
+ * @return pointer to the created chart
+ */
+lv_obj_t * shot_chart_create(lv_obj_t * parent);
+
+/**
+ * Set the value range of an axis
+ * @param obj pointer to a chart object
+ * @param axis the axis
+ * @param min value at the bottom in 1/SHOT_SERIES_SCALE units
+ * @param max value at the top in 1/SHOT_SERIES_SCALE units
+ */
+void shot_chart_set_range(lv_obj_t * obj, shot_chart_axis_t axis, int32_t min, int32_t max);
+
+/**
+ * Show a channel of the shot series
+ * @param obj pointer to a chart object
+ * @param ch the channel
+ * @param color color of the channel
+ * @param axis the axis the channel is scaled to
+ */
+void shot_chart_set_channel(lv_obj_t * obj, shot_channel_t ch, lv_color_t color, shot_chart_axis_t axis);
+
+/**
+ * Set the mode of the time axis
+ * @param obj pointer to a chart object
+ * @param mode SHOT_CHART_MODE_FIT or SHOT_CHART_MODE_SCROLL
+ */
+void shot_chart_set_mode(lv_obj_t * obj, shot_chart_mode_t mode);
+
+/**
+ * Get the mode of the time axis
+ * @param obj pointer to a chart object
+ */
+shot_chart_mode_t shot_chart_get_mode(const lv_obj_t * obj);
+
+/**
+ * Set a target profile drawn into the background in fit mode, stretched over the plot width
+ * @param obj pointer to a chart object
+ * @param values target values in 1/SHOT_SERIES_SCALE units, copied. NULL to remove the target.
+ * @param cnt number of values
+ * @param color color of the target
+ * @param axis the axis the target is scaled to
+ */
+void shot_chart_set_target(lv_obj_t * obj, const int16_t * values, uint16_t cnt, lv_color_t color,
+                           shot_chart_axis_t axis);
+
+/**
+ * Pick up the samples pushed to the shot series since the last refresh.
+ * Only the columns that changed are composed and only their changed rows are invalidated.
+ * A reset series is redrawn completely.
+ * @param obj pointer to a chart object
+ */
+void shot_chart_refresh(lv_obj_t * obj);
+
+/**
+ * Get the width of the plot area, one column per bucket or sample
+ * @param obj pointer to a chart object
+ */
+lv_coord_t shot_chart_get_plot_width(const lv_obj_t * obj);
+
+/**
+ * Get the update statistics of a chart
+ * @param obj pointer to a chart object
+ * @param stats store the statistics here
+ */
+void shot_chart_get_stats(const lv_obj_t * obj, shot_chart_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*SHOT_CHART_H*/
@@ -0,0 +1,206 @@
+/**
+ * @file shot_series.c
+ * Time series of a shot (pressure, flow, temperature, weight) with incremental decimation for plotting
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "shot_series.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_WIDTH   256
+#define STORE_MAX       (2 * SHOT_SERIES_MAX_BUCKETS)   // Stored buckets are merged once they reach twice the width
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void merge_buckets(void);
+static const shot_bucket_t * stored_bucket(shot_channel_t ch, uint32_t i);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+// Raw samples, one array per channel
+static int16_t samples[SHOT_CH_COUNT][SHOT_SERIES_CAPACITY];
+static uint32_t sample_time[SHOT_SERIES_CAPACITY];
+static uint32_t head;       // Index of the oldest sample
+static uint32_t count;
+static uint32_t total;
+static uint32_t generation;     // Incremented by every reset
+
+// Decimated shot, one array per channel, between `width` and twice as many buckets once the shot is long enough
+static shot_bucket_t buckets[SHOT_CH_COUNT][STORE_MAX];
+static shot_bucket_t partial[SHOT_CH_COUNT];    // Bucket being filled
+static uint32_t partial_cnt;                    // Samples in the partial bucket
+static uint16_t bucket_cnt;                     // Complete buckets
+static uint32_t bucket_span = 1;
+static uint16_t width = DEFAULT_WIDTH;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Merge neighbouring buckets pairwise, halving their number and doubling the span */
+static void merge_buckets(void)
+{
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        shot_bucket_t * b = buckets[ch];
+        for (uint16_t i = 0; i < bucket_cnt / 2; i++) {
+            shot_bucket_t merged;
+            merged.min = b[2 * i].min < b[2 * i + 1].min ? b[2 * i].min : b[2 * i + 1].min;
+            merged.max = b[2 * i].max > b[2 * i + 1].max ? b[2 * i].max : b[2 * i + 1].max;
+            b[i] = merged;
+        }
+        // An odd last bucket becomes the start of the new partial one
+        if (bucket_cnt & 1) {
+            shot_bucket_t * last = &b[bucket_cnt - 1];
+            if (partial_cnt == 0) {
+                partial[ch] = *last;
+            } else {
+                if (last->min < partial[ch].min) partial[ch].min = last->min;
+                if (last->max > partial[ch].max) partial[ch].max = last->max;
+            }
+        }
+    }
+
+    if (bucket_cnt & 1) partial_cnt += bucket_span;
+    bucket_cnt /= 2;
+    bucket_span *= 2;
+}
+
+/* Complete buckets first, then the partial one */
+static const shot_bucket_t * stored_bucket(shot_channel_t ch, uint32_t i)
+{
+    return i < bucket_cnt ? &buckets[ch][i] : &partial[ch];
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void shot_series_reset(void)
+{
+    head = 0;
+    count = 0;
+    total = 0;
+    partial_cnt = 0;
+    bucket_cnt = 0;
+    bucket_span = 1;
+    generation++;
+}
+
+void shot_series_set_width(uint16_t w)
+{
+    if (w == 0) w = 1;
+    if (w > SHOT_SERIES_MAX_BUCKETS) w = SHOT_SERIES_MAX_BUCKETS;
+    width = w;
+
+    // The partial bucket counts towards the stored ones too
+    while (bucket_cnt + (partial_cnt ? 1 : 0) > 2 * width && bucket_cnt > 1) {
+        merge_buckets();
+    }
+}
+
+void shot_series_push(uint32_t time_ms, const int16_t values[SHOT_CH_COUNT])
+{
+    uint32_t idx = (head + count) % SHOT_SERIES_CAPACITY;
+    if (count == SHOT_SERIES_CAPACITY) {
+        head = (head + 1) % SHOT_SERIES_CAPACITY;
+    } else {
+        count++;
+    }
+    total++;
+
+    sample_time[idx] = time_ms;
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        int16_t v = values[ch];
+        samples[ch][idx] = v;
+
+        if (partial_cnt == 0) {
+            partial[ch].min = v;
+            partial[ch].max = v;
+        } else {
+            if (v < partial[ch].min) partial[ch].min = v;
+            if (v > partial[ch].max) partial[ch].max = v;
+        }
+    }
+    partial_cnt++;
+
+    if (partial_cnt < bucket_span) return;
+
+    // Close the bucket, merge when there would be no room for the next partial one.
+    // Halving 2 * width buckets leaves `width` of them, so the stored ones never drop below the width.
+    for (int ch = 0; ch < SHOT_CH_COUNT; ch++) {
+        buckets[ch][bucket_cnt] = partial[ch];
+    }
+    bucket_cnt++;
+    partial_cnt = 0;
+
+    if (bucket_cnt >= 2 * width) {
+        merge_buckets();
+    }
+}
+
+uint32_t shot_series_get_count(void)
+{
+    return count;
+}
+
+uint32_t shot_series_get_total(void)
+{
+    return total;
+}
+
+uint32_t shot_series_get_generation(void)
+{
+    return generation;
+}
+
+int16_t shot_series_get(shot_channel_t ch, uint32_t index)
+{
+    if (index >= count) return 0;
+    return samples[ch][(head + index) % SHOT_SERIES_CAPACITY];
+}
+
+uint32_t shot_series_get_time(uint32_t index)
+{
+    if (index >= count) return 0;
+    return sample_time[(head + index) % SHOT_SERIES_CAPACITY];
+}
+
+uint16_t shot_series_get_buckets(shot_channel_t ch, shot_bucket_t * out, uint16_t max)
+{
+    uint32_t stored = bucket_cnt + (partial_cnt ? 1 : 0);
+    uint32_t n = stored;
+    if (n > width) n = width;
+    if (n > max) n = max;
+
+    // Each returned bucket merges an equal share of the stored ones, one or two at the full width
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t first = i * stored / n;
+        uint32_t end = (i + 1) * stored / n;
+        out[i] = *stored_bucket(ch, first);
+        for (uint32_t j = first + 1; j < end; j++) {
+            const shot_bucket_t * b = stored_bucket(ch, j);
+            if (b->min < out[i].min) out[i].min = b->min;
+            if (b->max > out[i].max) out[i].max = b->max;
+        }
+    }
+    return (uint16_t)n;
+}
+
+uint32_t shot_series_get_bucket_span(void)
+{
+    return bucket_span;
+}
+
+int16_t shot_series_fixed(int32_t value, int32_t div)
+{
+    int32_t v = value * SHOT_SERIES_SCALE / div;
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v < INT16_MIN) return INT16_MIN;
+    return (int16_t)v;
+}
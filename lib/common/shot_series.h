@@ -0,0 +1,123 @@
+/**
+ * @file shot_series.h
+ * Time series of a shot (pressure, flow, temperature, weight) with incremental decimation for plotting
+ */
+
+#ifndef SHOT_SERIES_H
+#define SHOT_SERIES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SHOT_SERIES_CAPACITY    1024    // Raw samples kept, 100 s at 10 Hz
+#define SHOT_SERIES_MAX_BUCKETS 512     // Upper limit of the decimation width
+#define SHOT_SERIES_SCALE       100     // Samples are stored in 1/100 units
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    SHOT_CH_PRESSURE,   // bar
+    SHOT_CH_FLOW,       // ml/s
+    SHOT_CH_TEMP,       // °C
+    SHOT_CH_WEIGHT,     // g
+    SHOT_CH_COUNT
+} shot_channel_t;
+
+typedef struct {
+    int16_t min;
+    int16_t max;
+} shot_bucket_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start a new shot, the raw samples and the decimated buckets are dropped
+ */
+void shot_series_reset(void);
+
+/**
+ * Set how many buckets the whole shot is decimated to, typically the plot width in pixels.
+ * Up to twice as many buckets are stored, existing ones are merged if there are more.
+ * @param width number of buckets, at most SHOT_SERIES_MAX_BUCKETS
+ */
+void shot_series_set_width(uint16_t width);
+
+/**
+ * Append a sample of every channel. The oldest raw sample is overwritten once the ring is full,
+ * the decimated buckets always cover the whole shot.
+ * @param time_ms time of the sample
+ * @param values one value per channel in 1/SHOT_SERIES_SCALE units
+ */
+void shot_series_push(uint32_t time_ms, const int16_t values[SHOT_CH_COUNT]);
+
+/**
+ * Get the number of raw samples held
+ */
+uint32_t shot_series_get_count(void);
+
+/**
+ * Get the number of samples pushed since the last reset
+ */
+uint32_t shot_series_get_total(void);
+
+/**
+ * Get the number of resets, to tell a new shot from the previous one with as many samples
+ */
+uint32_t shot_series_get_generation(void);
+
+/**
+ * Get a raw sample
+ * @param ch the channel
+ * @param index 0 is the oldest held sample
+ * @return the value in 1/SHOT_SERIES_SCALE units
+ */
+int16_t shot_series_get(shot_channel_t ch, uint32_t index);
+
+/**
+ * Get the time of a raw sample
+ * @param index 0 is the oldest held sample
+ */
+uint32_t shot_series_get_time(uint32_t index);
+
+/**
+ * Get the min/max buckets of a channel covering the whole shot. Once the shot has more samples
+ * than the decimation width, exactly that many buckets are returned, each merging one or two
+ * stored buckets of `shot_series_get_bucket_span()` samples. The last stored bucket may be partial.
+ * @param ch the channel
+ * @param buckets store the buckets here
+ * @param max size of `buckets`
+ * @return number of buckets stored, the decimation width or `max` if the shot is long enough
+ */
+uint16_t shot_series_get_buckets(shot_channel_t ch, shot_bucket_t * buckets, uint16_t max);
+
+/**
+ * Get the number of samples merged into one stored bucket, doubles whenever the stored buckets
+ * reach twice the width
+ */
+uint32_t shot_series_get_bucket_span(void);
+
+/**
+ * Convert a value to the fixed point format, clamped to the int16_t range
+ * @param value the value multiplied by `div`
+ * @param div divisor of `value`, e.g. 10 for a value in 1/10 units
+ */
+int16_t shot_series_fixed(int32_t value, int32_t div);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*SHOT_SERIES_H*/
@@ -0,0 +1,241 @@
+/**
+ * @file ui_bench.c
+ * Replay of a standard UI scenario with frame time measurement
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "ui_bench.h"
+#include "nextion_parser.h"
+#include "lv_gaggiuino_ui.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FRAME_PERIOD    LV_DISP_DEF_REFR_PERIOD
+#define WARMUP_TIME     3000    // ms of virtual time, enough to build the UI behind the splash
+#define SETTLE_FRAMES   25      // Frames to let a page transition finish
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char * cmd;   // Nextion command fed to the message handler
+    uint16_t frames;    // Frames to render after the command
+} bench_step_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void bench_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static int cmp_u32(const void * a, const void * b);
+static void bench_begin(lv_disp_t * disp, ui_bench_result_t * res);
+static void bench_frame(ui_bench_result_t * res);
+static void bench_end(ui_bench_result_t * res);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* The standard scenario: what the controller sends while heating up, pulling a shot and
+ * browsing through every page. Keep it stable so results stay comparable over time. */
+static const bench_step_t scenario[] = {
+    {"page home", 10},
+    {"home.qPf1.txt=\"Default\"", 1},
+    {"home.qPf2.txt=\"Londinium\"", 1},
+    {"home.qPf3.txt=\"Adaptive\"", 1},
+    {"home.qPf4.txt=\"Filter 2.1\"", 1},
+    {"currentTemp=88", 2},
+    {"currentTemp=89", 2},
+    {"currentTemp=90", 2},
+    {"currentTemp=91", 2},
+    {"currentTemp=92", 2},
+    {"currentTemp=93", 2},
+    {"page brew", 25},
+    {"pressure.val=20", 2},
+    {"pressure.val=45", 2},
+    {"pressure.val=90", 2},
+    {"flow.val=12", 2},
+    {"weight.txt=\"18.4\"", 2},
+    {"page plot", 25},
+    {"pressure.val=88", 2},
+    {"pressure.val=86", 2},
+    {"flow.val=20", 2},
+    {"weight.txt=\"36.0\"", 2},
+    {"page clean", 25},
+    {"page settings", 25},
+    {"popupMSG.t0.txt=\"Brew finished\"", 1},
+    {"page popupMSG", 10},
+    {"page home", 25},
+};
+
+static uint32_t frame_us[UI_BENCH_MAX_FRAMES];
+static uint32_t frame_px;
+static bool frame_rendered;
+static lv_disp_drv_t * monitored_drv;
+static lv_disp_draw_buf_t * monitored_draw_buf;
+static void (*prev_monitor_cb)(lv_disp_drv_t *, uint32_t, uint32_t);
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void bench_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    frame_px += px;
+    frame_rendered = true;
+    if (prev_monitor_cb) prev_monitor_cb(drv, time, px);
+}
+
+static int cmp_u32(const void * a, const void * b)
+{
+    uint32_t va = *(const uint32_t *)a;
+    uint32_t vb = *(const uint32_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+static void bench_begin(lv_disp_t * disp, ui_bench_result_t * res)
+{
+    memset(res, 0, sizeof(*res));
+
+    monitored_drv = disp->driver;
+    monitored_draw_buf = lv_disp_get_draw_buf(disp);
+    prev_monitor_cb = monitored_drv->monitor_cb;
+    monitored_drv->monitor_cb = bench_monitor_cb;
+}
+
+/* Advance the clock by one frame period and time the refresh if anything was rendered */
+static void bench_frame(ui_bench_result_t * res)
+{
+    lv_tick_inc(FRAME_PERIOD);
+
+    frame_px = 0;
+    frame_rendered = false;
+    uint32_t start = ui_bench_time_us();
+    lv_timer_handler();
+    // Count asynchronous flushes of the frame too
+    while (monitored_draw_buf->flushing) {
+        if (monitored_drv->wait_cb) monitored_drv->wait_cb(monitored_drv);
+    }
+    uint32_t elapsed = ui_bench_time_us() - start;
+
+    if (!frame_rendered) return;
+
+    if (res->frames < UI_BENCH_MAX_FRAMES) {
+        frame_us[res->frames] = elapsed;
+    }
+    res->frames++;
+    res->rendered_px += frame_px;
+    res->total_us += elapsed;
+    if (elapsed > res->max_us) res->max_us = elapsed;
+}
+
+static void bench_end(ui_bench_result_t * res)
+{
+    monitored_drv->monitor_cb = prev_monitor_cb;
+
+    if (res->frames == 0) return;
+
+    uint32_t stored = LV_MIN(res->frames, UI_BENCH_MAX_FRAMES);
+    qsort(frame_us, stored, sizeof(frame_us[0]), cmp_u32);
+    res->avg_us = res->total_us / res->frames;
+    res->p95_us = frame_us[(stored * 95) / 100];
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+uint32_t ui_bench_time_us(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+#endif
+}
+
+void ui_bench_warmup(void)
+{
+    for (uint32_t t = 0; t < WARMUP_TIME; t += FRAME_PERIOD) {
+        lv_tick_inc(FRAME_PERIOD);
+        lv_timer_handler();
+    }
+}
+
+void ui_bench_run(lv_disp_t * disp, ui_bench_result_t * res)
+{
+    bench_begin(disp, res);
+
+    // Start every run from a fully drawn screen
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+
+    for (size_t i = 0; i < sizeof(scenario) / sizeof(scenario[0]); i++) {
+        const bench_step_t * step = &scenario[i];
+        nextion_msg_handler_process((const uint8_t *)step->cmd, (uint16_t)strlen(step->cmd));
+
+        for (uint16_t f = 0; f < step->frames; f++) {
+            bench_frame(res);
+        }
+    }
+
+    lv_gaggiuino_hide_popup();
+    bench_end(res);
+}
+
+uint32_t ui_bench_replay(uint32_t rounds, nextion_message_callback_t cb)
+{
+    static const uint8_t terminator[] = {0xFF, 0xFF, 0xFF};
+    static nextion_parser_t parser;
+    nextion_parser_init(&parser);
+
+    uint32_t messages = 0;
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < sizeof(scenario) / sizeof(scenario[0]); i++) {
+            const bench_step_t * step = &scenario[i];
+            for (const char * c = step->cmd; *c; c++) {
+                nextion_parser_process_byte(&parser, (uint8_t)*c, cb);
+            }
+            for (size_t t = 0; t < sizeof(terminator); t++) {
+                if (nextion_parser_process_byte(&parser, terminator[t], cb)) messages++;
+            }
+
+            for (uint16_t f = 0; f < step->frames; f++) {
+                lv_tick_inc(FRAME_PERIOD);
+                lv_timer_handler();
+            }
+        }
+        lv_gaggiuino_hide_popup();
+    }
+
+    return messages;
+}
+
+void ui_bench_run_screen(lv_disp_t * disp, const char * page, uint16_t frames, ui_bench_result_t * res)
+{
+    lv_gaggiuino_show_page(page);
+    for (uint16_t f = 0; f < SETTLE_FRAMES; f++) {
+        lv_tick_inc(FRAME_PERIOD);
+        lv_timer_handler();
+    }
+
+    bench_begin(disp, res);
+
+    for (uint16_t f = 0; f < frames; f++) {
+        lv_obj_invalidate(lv_disp_get_scr_act(disp));
+        bench_frame(res);
+    }
+
+    bench_end(res);
+}
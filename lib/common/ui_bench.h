@@ -0,0 +1,81 @@
+/**
+ * @file ui_bench.h
+ * Replay of a standard UI scenario with frame time measurement
+ */
+
+#ifndef UI_BENCH_H
+#define UI_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "lvgl.h"
+#include "nextion_parser.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UI_BENCH_MAX_FRAMES 512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t frames;        // Refreshes that actually rendered something
+    uint32_t rendered_px;   // Sum of rendered pixels over all frames
+    uint32_t avg_us;
+    uint32_t p95_us;
+    uint32_t max_us;
+    uint32_t total_us;
+} ui_bench_result_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Run the LVGL timers with a virtual clock until the main UI is up.
+ * The caller must not advance the tick from anywhere else while benchmarking.
+ */
+void ui_bench_warmup(void);
+
+/**
+ * Replay the standard scenario (page transitions, telemetry updates, popup) once
+ * @param disp the display to measure
+ * @param res store the measurement here
+ */
+void ui_bench_run(lv_disp_t * disp, ui_bench_result_t * res);
+
+/**
+ * Show a page and redraw the whole screen a number of times, to measure raw rendering speed
+ * @param disp the display to measure
+ * @param page Nextion page name, e.g. "home"
+ * @param frames number of full screen redraws
+ * @param res store the measurement here
+ */
+void ui_bench_run_screen(lv_disp_t * disp, const char * page, uint16_t frames, ui_bench_result_t * res);
+
+/**
+ * Send the standard scenario through a Nextion parser byte by byte, terminated like on the wire,
+ * and run the frames of each step with a virtual clock. Nothing is measured.
+ * @param rounds number of times to replay the scenario
+ * @param cb called with every complete message, e.g. nextion_msg_handler_process
+ * @return number of messages completed by the parser
+ */
+uint32_t ui_bench_replay(uint32_t rounds, nextion_message_callback_t cb);
+
+/**
+ * Get a monotonic timestamp in microseconds
+ */
+uint32_t ui_bench_time_us(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_BENCH_H*/
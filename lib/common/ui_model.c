@@ -0,0 +1,97 @@
+/**
+ * @file ui_model.c
+ * Store of the values sent by the controller, independent of the widgets showing them
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "ui_model.h"
+#include "ui_text.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    char key[UI_MODEL_KEY_MAX];
+    ui_text_t text;
+    int32_t value;
+    bool has_text;
+    bool has_value;
+} model_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static model_entry_t * find_entry(const char * key, bool create);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static model_entry_t entries[UI_MODEL_MAX_ENTRIES];
+static uint16_t entry_cnt;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static model_entry_t * find_entry(const char * key, bool create)
+{
+    for (uint16_t i = 0; i < entry_cnt; i++) {
+        if (strcmp(entries[i].key, key) == 0) return &entries[i];
+    }
+
+    if (!create || entry_cnt >= UI_MODEL_MAX_ENTRIES || strlen(key) >= UI_MODEL_KEY_MAX) return NULL;
+
+    model_entry_t * entry = &entries[entry_cnt++];
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->key, key);
+    return entry;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+bool ui_model_set_text(const char * key, const char * text, size_t len)
+{
+    model_entry_t * entry = find_entry(key, true);
+    if (entry == NULL || !ui_text_set(&entry->text, text, len)) return false;
+
+    entry->has_text = true;
+    return true;
+}
+
+const char * ui_model_get_text(const char * key)
+{
+    model_entry_t * entry = find_entry(key, false);
+    return entry && entry->has_text ? ui_text_get(&entry->text) : NULL;
+}
+
+bool ui_model_set_value(const char * key, int32_t value)
+{
+    model_entry_t * entry = find_entry(key, true);
+    if (entry == NULL) return false;
+
+    entry->value = value;
+    entry->has_value = true;
+    return true;
+}
+
+bool ui_model_get_value(const char * key, int32_t * value)
+{
+    model_entry_t * entry = find_entry(key, false);
+    if (entry == NULL || !entry->has_value) return false;
+
+    *value = entry->value;
+    return true;
+}
+
+void ui_model_clear(void)
+{
+    for (uint16_t i = 0; i < entry_cnt; i++) {
+        ui_text_free(&entries[i].text);
+    }
+    entry_cnt = 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ui_model.h
+ * Store of the values sent by the controller, independent of the widgets showing them
+ */
+
+#ifndef UI_MODEL_H
+#define UI_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UI_MODEL_MAX_ENTRIES    32
+#define UI_MODEL_KEY_MAX        32      // Including the terminating zero
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Store the text of an object, of any length. Short texts are kept inline, see ui_text.h.
+ * @param key Nextion object name, e.g. "home.qPf1"
+ * @param text the characters, e.g. straight from the receive buffer, not necessarily terminated
+ * @param len number of characters
+ * @return false if the store or the heap is full
+ */
+bool ui_model_set_text(const char * key, const char * text, size_t len);
+
+/**
+ * Get the stored text of an object. The pointer stays valid until the object gets a longer text
+ * that doesn't fit its storage, so widgets may show it without a copy.
+ * @param key Nextion object name
+ * @return the text or NULL if none was stored
+ */
+const char * ui_model_get_text(const char * key);
+
+/**
+ * Store a numeric value, e.g. of a Nextion variable or a `.val` attribute
+ * @param key variable or object name, e.g. "currentTemp" or "pressure"
+ * @param value the value
+ * @return false if the store is full
+ */
+bool ui_model_set_value(const char * key, int32_t value);
+
+/**
+ * Get a stored numeric value
+ * @param key variable or object name
+ * @param value store the value here
+ * @return false if no value was stored
+ */
+bool ui_model_get_value(const char * key, int32_t * value);
+
+/**
+ * Forget every stored value
+ */
+void ui_model_clear(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_MODEL_H*/
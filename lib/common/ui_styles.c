@@ -0,0 +1,105 @@
+/**
+ * @file ui_styles.c
+ * Styles shared by all pages. They are constant, initialized at compile time, and objects only
+ * reference them instead of carrying a local style each. `obj_census_print_local_styles()`
+ * reports the local styles left.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "ui_styles.h"
+#include "mem_pool.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROPS_END   {.prop = LV_STYLE_PROP_INV}
+
+#define CONST_PAD_ALL(v) \
+    LV_STYLE_CONST_PAD_TOP(v), LV_STYLE_CONST_PAD_BOTTOM(v), LV_STYLE_CONST_PAD_LEFT(v), LV_STYLE_CONST_PAD_RIGHT(v)
+
+#define COLOR_RED   LV_COLOR_MAKE(0xF4, 0x43, 0x36)     // lv_palette_main(LV_PALETTE_RED)
+#define COLOR_WHITE LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_style_const_prop_t no_border_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(no_border, no_border_props);
+
+static const lv_style_const_prop_t gauge_needle_props[] = {
+    LV_STYLE_CONST_LINE_COLOR(COLOR_RED),
+    LV_STYLE_CONST_BG_COLOR(COLOR_RED),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(gauge_needle, gauge_needle_props);
+
+static const lv_style_const_prop_t readout_large_props[] = {
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserrat_28),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(readout_large, readout_large_props);
+
+static const lv_style_const_prop_t readout_props[] = {
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserrat_20),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(readout, readout_props);
+
+static const lv_style_const_prop_t list_props[] = {
+    CONST_PAD_ALL(10),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(list, list_props);
+
+static const lv_style_const_prop_t panel_props[] = {
+    CONST_PAD_ALL(20),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(panel, panel_props);
+
+static const lv_style_const_prop_t popup_props[] = {
+    LV_STYLE_CONST_PAD_ROW(10),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(popup, popup_props);
+
+static const lv_style_const_prop_t text_center_props[] = {
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(text_center, text_center_props);
+
+static const lv_style_const_prop_t splash_props[] = {
+    LV_STYLE_CONST_BG_COLOR(COLOR_WHITE),
+    PROPS_END
+};
+static LV_STYLE_CONST_INIT(splash, splash_props);
+
+static const lv_style_t * const styles[UI_STYLE_COUNT] = {
+    [UI_STYLE_NO_BORDER] = &no_border,
+    [UI_STYLE_GAUGE_NEEDLE] = &gauge_needle,
+    [UI_STYLE_READOUT_LARGE] = &readout_large,
+    [UI_STYLE_READOUT] = &readout,
+    [UI_STYLE_LIST] = &list,
+    [UI_STYLE_PANEL] = &panel,
+    [UI_STYLE_POPUP] = &popup,
+    [UI_STYLE_TEXT_CENTER] = &text_center,
+    [UI_STYLE_SPLASH] = &splash,
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void ui_styles_add(lv_obj_t * obj, ui_style_t style, lv_style_selector_t selector)
+{
+    // LVGL never writes to a constant style, lv_obj_add_style() just doesn't take one
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_STYLES);
+    lv_obj_add_style(obj, (lv_style_t *)styles[style], selector);
+    mem_pool_set_tag(prev_tag);
+}
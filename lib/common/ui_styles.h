@@ -0,0 +1,53 @@
+/**
+ * @file ui_styles.h
+ * Styles shared by all pages. They are constant, initialized at compile time, and objects only
+ * reference them instead of carrying a local style each. `obj_census_print_local_styles()`
+ * reports the local styles left.
+ */
+
+#ifndef UI_STYLES_H
+#define UI_STYLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    UI_STYLE_NO_BORDER,         // Tab buttons
+    UI_STYLE_GAUGE_NEEDLE,      // Needle of the temperature gauge, for LV_PART_INDICATOR
+    UI_STYLE_READOUT_LARGE,     // Home temperature, a font of the glyph atlas
+    UI_STYLE_READOUT,           // Brew values, a font of the glyph atlas
+    UI_STYLE_LIST,              // Padding of the page lists
+    UI_STYLE_PANEL,             // Padding of the button panels
+    UI_STYLE_POPUP,             // Row gap of the popup
+    UI_STYLE_TEXT_CENTER,
+    UI_STYLE_SPLASH,            // Background behind the logo
+    UI_STYLE_COUNT
+} ui_style_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Add a shared style to an object. Only the reference in the style list of the object is
+ * allocated, tagged MEM_TAG_STYLES.
+ * @param obj pointer to an object
+ * @param style the style
+ * @param selector OR-ed part and state, like lv_obj_add_style()
+ */
+void ui_styles_add(lv_obj_t * obj, ui_style_t style, lv_style_selector_t selector);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_STYLES_H*/
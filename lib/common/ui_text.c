@@ -0,0 +1,75 @@
+/**
+ * @file ui_text.c
+ * Owned text with small string optimization: short texts are stored inline,
+ * longer ones in the LVGL heap. Any length is kept, nothing is truncated.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "ui_text.h"
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HEAP_ROUND  32      // Heap blocks grow in steps, so small changes of a long text don't move it
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void ui_text_init(ui_text_t * text)
+{
+    memset(text, 0, sizeof(*text));
+}
+
+bool ui_text_set(ui_text_t * text, const char * str, size_t len)
+{
+    if (len > UINT16_MAX - HEAP_ROUND) return false;
+
+    if (text->cap > len) {
+        // Once on the heap a text stays there, its pointer stays valid
+        memmove(text->u.heap, str, len);
+        text->u.heap[len] = '\0';
+    } else if (text->cap == 0 && len < UI_TEXT_INLINE) {
+        memmove(text->u.buf, str, len);
+        text->u.buf[len] = '\0';
+    } else {
+        uint16_t cap = (uint16_t)((len + HEAP_ROUND) & ~(size_t)(HEAP_ROUND - 1));
+        char * heap = lv_mem_alloc(cap);
+        if (heap == NULL) return false;
+        memcpy(heap, str, len);
+        heap[len] = '\0';
+        if (text->cap) lv_mem_free(text->u.heap);
+        text->u.heap = heap;
+        text->cap = cap;
+    }
+
+    text->len = (uint16_t)len;
+    return true;
+}
+
+const char * ui_text_get(const ui_text_t * text)
+{
+    return text->cap ? text->u.heap : text->u.buf;
+}
+
+bool ui_text_equals(const ui_text_t * text, const char * str, size_t len)
+{
+    return text->len == len && memcmp(ui_text_get(text), str, len) == 0;
+}
+
+void ui_text_swap(ui_text_t * a, ui_text_t * b)
+{
+    ui_text_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+void ui_text_free(ui_text_t * text)
+{
+    if (text->cap) lv_mem_free(text->u.heap);
+    ui_text_init(text);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file ui_text.h
+ * Owned text with small string optimization: short texts are stored inline,
+ * longer ones in the LVGL heap. Any length is kept, nothing is truncated.
+ */
+
+#ifndef UI_TEXT_H
+#define UI_TEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UI_TEXT_INLINE  24      // Texts shorter than this are stored inline, e.g. telemetry and profile names
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint16_t len;
+    uint16_t cap;           // Size of the heap block, 0 while the text is inline
+    union {
+        char buf[UI_TEXT_INLINE];
+        char * heap;
+    } u;
+} ui_text_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize an empty text
+ */
+void ui_text_init(ui_text_t * text);
+
+/**
+ * Replace a text. The storage only moves when a longer text doesn't fit,
+ * otherwise ui_text_get() keeps returning the same pointer.
+ * @param text the text
+ * @param str the new characters, not necessarily terminated
+ * @param len number of characters
+ * @return false if the heap is exhausted, the text is unchanged then
+ */
+bool ui_text_set(ui_text_t * text, const char * str, size_t len);
+
+/**
+ * Get the characters of a text, zero terminated
+ */
+const char * ui_text_get(const ui_text_t * text);
+
+/**
+ * Check if a text equals a string
+ * @param str the characters, not necessarily terminated
+ * @param len number of characters
+ */
+bool ui_text_equals(const ui_text_t * text, const char * str, size_t len);
+
+/**
+ * Exchange the storage of two texts, nothing is copied
+ */
+void ui_text_swap(ui_text_t * a, ui_text_t * b);
+
+/**
+ * Free the heap block of a text, it's empty afterwards
+ */
+void ui_text_free(ui_text_t * text);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_TEXT_H*/
@@ -0,0 +1,248 @@
+/**
+ * @file vlist.c
+ * Virtual list: a scrollable list of fixed height rows that only keeps the visible ones as objects
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "vlist.h"
+#include "metrics.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &vlist_class
+
+#define DEFAULT_ROW_HEIGHT  40
+#define INDEX_NONE          UINT32_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_obj_t obj;
+    vlist_create_cb_t create_cb;
+    vlist_bind_cb_t bind_cb;
+    uint32_t count;         // Entries shown, at most max_count()
+    uint32_t count_set;     // Entries set by vlist_set_count()
+    lv_coord_t row_h;
+    lv_obj_t * rows[VLIST_MAX_ROWS];
+    uint32_t row_index[VLIST_MAX_ROWS];     // Entry bound to each row, INDEX_NONE if free
+    uint8_t row_cnt;
+    vlist_stats_t stats;
+} vlist_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void vlist_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void vlist_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static uint32_t max_count(const vlist_t * list);
+static void create_rows(vlist_t * list);
+static void bind_rows(vlist_t * list, bool rebind_all);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t vlist_class = {
+    .constructor_cb = vlist_constructor,
+    .event_cb = vlist_event,
+    .width_def = LV_PCT(100),
+    .height_def = LV_PCT(100),
+    .instance_size = sizeof(vlist_t),
+    .base_class = &lv_obj_class
+};
+
+static uint32_t * metric_binds;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void vlist_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    (void)class_p;
+    vlist_t * list = (vlist_t *)obj;
+
+    list->row_h = DEFAULT_ROW_HEIGHT;
+    lv_obj_set_scroll_dir(obj, LV_DIR_VER);
+
+    if (metric_binds == NULL) metric_binds = metrics_get("vlist.binds");
+}
+
+static void vlist_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    (void)class_p;
+
+    // Call the ancestor's event handler
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) return;
+
+    lv_event_code_t code = lv_event_get_code(e);
+    vlist_t * list = (vlist_t *)lv_event_get_target(e);
+
+    if (code == LV_EVENT_GET_SELF_SIZE) {
+        // The scrollable height of all entries, whether they have a row or not
+        lv_point_t * p = lv_event_get_param(e);
+        p->y = LV_MAX(p->y, (lv_coord_t)(list->count * list->row_h));
+    }
+    else if (code == LV_EVENT_SIZE_CHANGED || code == LV_EVENT_STYLE_CHANGED) {
+        create_rows(list);
+        bind_rows(list, false);
+    }
+    else if (code == LV_EVENT_SCROLL) {
+        bind_rows(list, false);
+    }
+}
+
+/**
+ * Get the number of entries whose rows end within LV_COORD_MAX. LVGL takes larger coordinates
+ * as LV_PCT() or other special values, or they wrap around.
+ */
+static uint32_t max_count(const vlist_t * list)
+{
+    return (uint32_t)(LV_COORD_MAX / list->row_h);
+}
+
+/**
+ * Create enough rows to cover the visible height, the margins and the row cut in half by scrolling
+ */
+static void create_rows(vlist_t * list)
+{
+    if (list->create_cb == NULL || list->row_h <= 0) return;
+
+    lv_coord_t visible_h = lv_obj_get_content_height(&list->obj);
+    uint32_t needed = (visible_h + list->row_h - 1) / list->row_h + 1 + 2 * VLIST_MARGIN_ROWS;
+    needed = LV_MIN(needed, list->count);
+    needed = LV_MIN(needed, VLIST_MAX_ROWS);
+
+    while (list->row_cnt < needed) {
+        lv_obj_t * row = list->create_cb(&list->obj);
+        lv_obj_set_size(row, LV_PCT(100), list->row_h);
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+        list->rows[list->row_cnt] = row;
+        list->row_index[list->row_cnt] = INDEX_NONE;
+        list->row_cnt++;
+        list->stats.rows++;
+    }
+}
+
+/**
+ * Bind the entries of the visible range to rows. Rows that scrolled out of the range are
+ * recycled for the entries that scrolled in, rows that stay in the range are not touched.
+ * @param rebind_all bind every row again, e.g. after the entries changed
+ */
+static void bind_rows(vlist_t * list, bool rebind_all)
+{
+    if (list->bind_cb == NULL || list->row_h <= 0 || list->row_cnt == 0) return;
+
+    lv_coord_t scroll_y = LV_MAX(lv_obj_get_scroll_y(&list->obj), 0);
+    uint32_t first = (uint32_t)(scroll_y / list->row_h);
+    first = first > VLIST_MARGIN_ROWS ? first - VLIST_MARGIN_ROWS : 0;
+    uint32_t end = LV_MIN(first + list->row_cnt, list->count);
+    if (end - first < list->row_cnt) first = end > list->row_cnt ? end - list->row_cnt : 0;
+
+    // Release the rows outside of the range
+    for (uint8_t i = 0; i < list->row_cnt; i++) {
+        uint32_t idx = list->row_index[i];
+        if (rebind_all || idx < first || idx >= end) list->row_index[i] = INDEX_NONE;
+    }
+
+    for (uint32_t idx = first; idx < end; idx++) {
+        bool bound = false;
+        for (uint8_t i = 0; i < list->row_cnt && !bound; i++) {
+            bound = list->row_index[i] == idx;
+        }
+        if (bound) continue;
+
+        for (uint8_t i = 0; i < list->row_cnt; i++) {
+            if (list->row_index[i] != INDEX_NONE) continue;
+
+            lv_obj_t * row = list->rows[i];
+            list->row_index[i] = idx;
+            lv_obj_set_y(row, (lv_coord_t)(idx * list->row_h));
+            lv_obj_clear_flag(row, LV_OBJ_FLAG_HIDDEN);
+            list->bind_cb(&list->obj, row, idx);
+            list->stats.binds++;
+            (*metric_binds)++;
+            break;
+        }
+    }
+
+    for (uint8_t i = 0; i < list->row_cnt; i++) {
+        if (list->row_index[i] == INDEX_NONE) lv_obj_add_flag(list->rows[i], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * vlist_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void vlist_set_row_height(lv_obj_t * obj, lv_coord_t height)
+{
+    vlist_t * list = (vlist_t *)obj;
+    if (height <= 0 || height == list->row_h) return;
+
+    list->row_h = height;
+    list->count = LV_MIN(list->count_set, max_count(list));
+    for (uint8_t i = 0; i < list->row_cnt; i++) {
+        lv_obj_set_height(list->rows[i], height);
+    }
+    lv_obj_refresh_self_size(obj);
+    create_rows(list);
+    bind_rows(list, true);
+}
+
+void vlist_set_source(lv_obj_t * obj, vlist_create_cb_t create_cb, vlist_bind_cb_t bind_cb)
+{
+    vlist_t * list = (vlist_t *)obj;
+
+    // Rows of another source can't be reused
+    for (uint8_t i = 0; i < list->row_cnt; i++) {
+        lv_obj_del(list->rows[i]);
+    }
+    list->row_cnt = 0;
+
+    list->create_cb = create_cb;
+    list->bind_cb = bind_cb;
+    create_rows(list);
+    bind_rows(list, true);
+}
+
+void vlist_set_count(lv_obj_t * obj, uint32_t count)
+{
+    vlist_t * list = (vlist_t *)obj;
+    if (count == list->count_set) return;
+
+    list->count_set = count;
+    list->count = LV_MIN(count, max_count(list));
+    lv_obj_refresh_self_size(obj);
+    create_rows(list);
+    bind_rows(list, true);
+}
+
+uint32_t vlist_get_count(const lv_obj_t * obj)
+{
+    const vlist_t * list = (const vlist_t *)obj;
+    return list->count;
+}
+
+void vlist_refresh(lv_obj_t * obj)
+{
+    bind_rows((vlist_t *)obj, true);
+}
+
+void vlist_get_stats(const lv_obj_t * obj, vlist_stats_t * stats)
+{
+    const vlist_t * list = (const vlist_t *)obj;
+    *stats = list->stats;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file vlist.h
+ * Virtual list: a scrollable list of fixed height rows that only keeps the visible ones as objects
+ */
+
+#ifndef VLIST_H
+#define VLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define VLIST_MAX_ROWS      32      // Upper limit of row objects per list
+#define VLIST_MARGIN_ROWS   1       // Rows kept bound above and below the visible ones
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * Create a row object, it is reused for any entry
+ * @param list the virtual list, use it as the parent
+ */
+typedef lv_obj_t * (*vlist_create_cb_t)(lv_obj_t * list);
+
+/**
+ * Show an entry in a row object
+ * @param list the virtual list
+ * @param row a row object created by the `vlist_create_cb_t`
+ * @param index the entry to show
+ */
+typedef void (*vlist_bind_cb_t)(lv_obj_t * list, lv_obj_t * row, uint32_t index);
+
+typedef struct {
+    uint32_t rows;      // Row objects created
+    uint32_t binds;     // Entries bound to a row
+} vlist_stats_t;
+
+extern const lv_obj_class_t vlist_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a virtual list. The rows are created on demand for the visible part of the list
+ * plus a small margin and bound to other entries while scrolling, so memory doesn't grow
+ * with the number of entries.
+ * @param parent pointer to an object, it will be the parent of the new list
+ * @return pointer to the created list
+ */
+lv_obj_t * vlist_create(lv_obj_t * parent);
+
+/**
+ * Set the height of every row
+ * @param obj pointer to a list object
+ * @param height the row height
+ */
+void vlist_set_row_height(lv_obj_t * obj, lv_coord_t height);
+
+/**
+ * Set the callbacks creating and binding the rows
+ * @param obj pointer to a list object
+ * @param create_cb creates a row object
+ * @param bind_cb shows an entry in a row object
+ */
+void vlist_set_source(lv_obj_t * obj, vlist_create_cb_t create_cb, vlist_bind_cb_t bind_cb);
+
+/**
+ * Set the number of entries. Only the entries within LV_COORD_MAX from the top are shown,
+ * that is LV_COORD_MAX / row height of them, e.g. 204 rows of 40 px with LVGL's default
+ * coordinates (LV_USE_LARGE_COORD 0). The rest is cut off.
+ * @param obj pointer to a list object
+ * @param count number of entries
+ */
+void vlist_set_count(lv_obj_t * obj, uint32_t count);
+
+/**
+ * Get the number of entries shown, see vlist_set_count()
+ * @param obj pointer to a list object
+ */
+uint32_t vlist_get_count(const lv_obj_t * obj);
+
+/**
+ * Bind the visible rows again after their entries changed
+ * @param obj pointer to a list object
+ */
+void vlist_refresh(lv_obj_t * obj);
+
+/**
+ * Get the row statistics of a list
+ * @param obj pointer to a list object
+ * @param stats store the statistics here
+ */
+void vlist_get_stats(const lv_obj_t * obj, vlist_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*VLIST_H*/
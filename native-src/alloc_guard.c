@@ -0,0 +1,87 @@
+#include "alloc_guard.h"
+#include <errno.h>
+#include <stdlib.h>
+
+// Calls of other threads (SDL, render threads) are not counted
+static __thread uint32_t armed;
+static alloc_guard_stats_t stats;
+
+#if defined(__GLIBC__)
+
+static void record_alloc(size_t size, void* caller) {
+    if (armed == 0) return;
+
+    if (stats.allocs == 0) {
+        stats.first_size = size;
+        stats.first_caller = caller;
+    }
+    stats.allocs++;
+}
+
+// The allocator behind malloc() and friends, the definitions below replace the public names
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    record_alloc(size, __builtin_return_address(0));
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) {
+    record_alloc(nmemb * size, __builtin_return_address(0));
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    record_alloc(size, __builtin_return_address(0));
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+    record_alloc(size, __builtin_return_address(0));
+    void* p = __libc_memalign(alignment, size);
+    if (p == NULL) return ENOMEM;
+    *memptr = p;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    record_alloc(size, __builtin_return_address(0));
+    return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr) {
+    if (armed != 0 && ptr != NULL) stats.frees++;
+    __libc_free(ptr);
+}
+
+bool alloc_guard_supported(void) {
+    return true;
+}
+
+#else
+
+bool alloc_guard_supported(void) {
+    return false;
+}
+
+#endif
+
+void alloc_guard_arm(void) {
+    armed++;
+}
+
+void alloc_guard_disarm(void) {
+    if (armed > 0) armed--;
+}
+
+void alloc_guard_get_stats(alloc_guard_stats_t* out) {
+    *out = stats;
+}
+
+void alloc_guard_reset(void) {
+    stats = (alloc_guard_stats_t){0};
+}
@@ -0,0 +1,50 @@
+#ifndef ALLOC_GUARD_H
+#define ALLOC_GUARD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t allocs;        // malloc, calloc, realloc, ... calls while armed
+    uint32_t frees;
+    size_t first_size;      // Size of the first allocation while armed
+    void* first_caller;     // Return address of the first allocation, for addr2line
+} alloc_guard_stats_t;
+
+/**
+ * Check if the system allocator can be interposed on this platform (glibc)
+ */
+bool alloc_guard_supported(void);
+
+/**
+ * Start counting the system heap calls of the calling thread.
+ * Calls nest, counting stops at the matching alloc_guard_disarm().
+ */
+void alloc_guard_arm(void);
+
+/**
+ * Stop counting the system heap calls of the calling thread
+ */
+void alloc_guard_disarm(void);
+
+/**
+ * Get the calls counted since the last alloc_guard_reset()
+ * @param stats Store the counters here
+ */
+void alloc_guard_get_stats(alloc_guard_stats_t* stats);
+
+/**
+ * Clear the counters
+ */
+void alloc_guard_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALLOC_GUARD_H
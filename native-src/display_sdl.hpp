@@ -3,6 +3,7 @@
 #ifdef NATIVE_LINUX
 #include <SDL2/SDL.h>
 #include "lvgl.h"
+#include "event_pump.h"
 
 extern SDL_Window* window;
 extern SDL_Renderer* renderer;
@@ -26,37 +27,38 @@ void display_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* c
 }
 
 void touchscreen_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
-    SDL_Event event;
     static int16_t last_x = 0;
     static int16_t last_y = 0;
+    static bool pressed = false;
 
-    if (SDL_PollEvent(&event)) {
+    // Events are collected by event_pump_poll() in the main loop. Stop at the first button
+    // transition so LVGL gets one sample per read and sees every click.
+    SDL_Event event;
+    while (event_pump_pop(EVENT_QUEUE_POINTER, &event)) {
+        bool was_pressed = pressed;
         switch (event.type) {
             case SDL_MOUSEMOTION:
                 last_x = event.motion.x;
                 last_y = event.motion.y;
-                data->point.x = last_x;
-                data->point.y = last_y;
-                data->state = LV_INDEV_STATE_PRESSED;
                 break;
             case SDL_MOUSEBUTTONDOWN:
                 last_x = event.button.x;
                 last_y = event.button.y;
-                data->point.x = last_x;
-                data->point.y = last_y;
-                data->state = LV_INDEV_STATE_PRESSED;
+                pressed = true;
                 break;
             case SDL_MOUSEBUTTONUP:
-                data->point.x = last_x;
-                data->point.y = last_y;
-                data->state = LV_INDEV_STATE_RELEASED;
+                pressed = false;
                 break;
             default:
-                data->state = LV_INDEV_STATE_RELEASED;
                 break;
         }
-    } else {
-        data->state = LV_INDEV_STATE_RELEASED;
+        if (pressed != was_pressed) {
+            break;
+        }
     }
+
+    data->point.x = last_x;
+    data->point.y = last_y;
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
 }
-#endif 
\ No newline at end of file
+#endif
@@ -0,0 +1,101 @@
+#include "event_pump.h"
+
+typedef struct {
+    SDL_Event events[EVENT_PUMP_QUEUE_SIZE];
+    uint16_t head;          // Oldest event
+    uint16_t count;
+    event_pump_stats_t stats;
+} event_ring_t;
+
+static event_ring_t queues[EVENT_QUEUE_COUNT];
+
+static event_queue_t classify(const SDL_Event* event) {
+    switch (event->type) {
+        case SDL_QUIT:
+            return EVENT_QUEUE_QUIT;
+        case SDL_WINDOWEVENT:
+            return event->window.event == SDL_WINDOWEVENT_CLOSE ? EVENT_QUEUE_QUIT : EVENT_QUEUE_WINDOW;
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEWHEEL:
+        case SDL_FINGERDOWN:
+        case SDL_FINGERUP:
+        case SDL_FINGERMOTION:
+            return EVENT_QUEUE_POINTER;
+        case SDL_KEYDOWN:
+        case SDL_TEXTINPUT:
+            return EVENT_QUEUE_KEYBOARD;
+        default:
+            return EVENT_QUEUE_COUNT;
+    }
+}
+
+static SDL_Event* newest(event_ring_t* ring) {
+    if (ring->count == 0) {
+        return NULL;
+    }
+    return &ring->events[(ring->head + ring->count - 1) % EVENT_PUMP_QUEUE_SIZE];
+}
+
+static void push(event_ring_t* ring, const SDL_Event* event) {
+    // Only the latest position matters between two button or finger transitions
+    SDL_Event* last = newest(ring);
+    if (last != NULL && last->type == event->type &&
+        (event->type == SDL_MOUSEMOTION || event->type == SDL_FINGERMOTION)) {
+        *last = *event;
+        ring->stats.coalesced++;
+        return;
+    }
+
+    if (ring->count == EVENT_PUMP_QUEUE_SIZE) {
+        ring->stats.dropped++;
+        return;
+    }
+
+    ring->events[(ring->head + ring->count) % EVENT_PUMP_QUEUE_SIZE] = *event;
+    ring->count++;
+    ring->stats.queued++;
+}
+
+void event_pump_poll(void) {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        event_queue_t queue = classify(&event);
+        if (queue == EVENT_QUEUE_COUNT) {
+            continue;
+        }
+        queues[queue].stats.polled++;
+        push(&queues[queue], &event);
+    }
+}
+
+bool event_pump_pop(event_queue_t queue, SDL_Event* event) {
+    event_ring_t* ring = &queues[queue];
+    if (ring->count == 0) {
+        return false;
+    }
+
+    *event = ring->events[ring->head];
+    ring->head = (ring->head + 1) % EVENT_PUMP_QUEUE_SIZE;
+    ring->count--;
+    return true;
+}
+
+const SDL_Event* event_pump_peek(event_queue_t queue) {
+    event_ring_t* ring = &queues[queue];
+    return ring->count ? &ring->events[ring->head] : NULL;
+}
+
+bool event_pump_quit_requested(void) {
+    SDL_Event event;
+    bool quit = false;
+    while (event_pump_pop(EVENT_QUEUE_QUIT, &event)) {
+        quit = true;
+    }
+    return quit;
+}
+
+void event_pump_get_stats(event_queue_t queue, event_pump_stats_t* stats) {
+    *stats = queues[queue].stats;
+}
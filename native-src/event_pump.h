@@ -0,0 +1,69 @@
+#ifndef EVENT_PUMP_H
+#define EVENT_PUMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <SDL2/SDL.h>
+
+#define EVENT_PUMP_QUEUE_SIZE 64
+
+typedef enum {
+    EVENT_QUEUE_POINTER,    // Mouse buttons, motion and wheel, touch fingers
+    EVENT_QUEUE_KEYBOARD,   // Key presses and text input
+    EVENT_QUEUE_WINDOW,     // Window events except close
+    EVENT_QUEUE_QUIT,       // SDL_QUIT and window close
+    EVENT_QUEUE_COUNT
+} event_queue_t;
+
+typedef struct {
+    uint32_t polled;        // Events taken from SDL
+    uint32_t queued;
+    uint32_t coalesced;     // Motion events merged into the previous one
+    uint32_t dropped;       // Events lost because the queue was full
+} event_pump_stats_t;
+
+/**
+ * Drain the SDL event queue into the per-subsystem queues.
+ * This is the only place calling SDL_PollEvent(), call it once per main loop iteration
+ * from the thread that created the window. Consecutive mouse or finger motion events are
+ * merged so readers see at most one motion sample between two other pointer events.
+ */
+void event_pump_poll(void);
+
+/**
+ * Take the oldest event of a queue
+ * @param queue The queue to read
+ * @param event Store the event here
+ * @return true if an event was taken, false if the queue is empty
+ */
+bool event_pump_pop(event_queue_t queue, SDL_Event* event);
+
+/**
+ * Look at the oldest event of a queue without taking it
+ * @param queue The queue to read
+ * @return The event or NULL if the queue is empty
+ */
+const SDL_Event* event_pump_peek(event_queue_t queue);
+
+/**
+ * Check if quitting was requested, the quit queue is drained
+ * @return true if the window was closed or SDL_QUIT received
+ */
+bool event_pump_quit_requested(void);
+
+/**
+ * Get the counters of a queue
+ * @param queue The queue
+ * @param stats Store the counters here
+ */
+void event_pump_get_stats(event_queue_t queue, event_pump_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_PUMP_H
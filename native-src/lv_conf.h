@@ -41,6 +41,14 @@
  */
 #define LV_USE_STDLIB_MALLOC    LV_STDLIB_CLIB
 
+/** The LVGL 8.3 heap, the same allocator as on the ESP32 so host measurements carry over.
+ *  Slabs and an arena with usage per tag, see lib/common/mem_pool.h */
+#define LV_MEM_CUSTOM 1
+#define LV_MEM_CUSTOM_INCLUDE "mem_pool.h"
+#define LV_MEM_CUSTOM_ALLOC   mem_pool_alloc
+#define LV_MEM_CUSTOM_FREE    mem_pool_free
+#define LV_MEM_CUSTOM_REALLOC mem_pool_realloc
+
 /** Possible values
  * - LV_STDLIB_BUILTIN:     LVGL's built in implementation
  * - LV_STDLIB_CLIB:        Standard C functions, like malloc, strlen, etc
@@ -983,7 +991,7 @@
 /* Documentation for several of the below items can be found here: https://docs.lvgl.io/master/details/auxiliary-modules/index.html . */
 
 /** 1: Enable API to take snapshot for object */
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /** 1: Enable system monitor component */
 #define LV_USE_SYSMON   0
@@ -51,6 +51,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include SDL_INCLUDE_PATH
+#include "../../event_pump.h"
 
 /*********************
  *      DEFINES
@@ -59,6 +60,8 @@
 #define KEYBOARD_BUFFER_SIZE SDL_TEXTINPUTEVENT_TEXT_SIZE
 #endif
 
+#define OVERLAY_MAX_AREAS 64
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -79,10 +82,9 @@ typedef struct {
  **********************/
 static void window_create(monitor_t * m);
 static void window_update(monitor_t * m);
-int quit_filter(void * userdata, SDL_Event * event);
 static void monitor_sdl_clean_up(void);
-static void sdl_event_handler(lv_timer_t * t);
 static void monitor_sdl_refr(lv_timer_t * t);
+static void pointer_drain(void);
 static void mouse_handler(SDL_Event * event);
 static void mousewheel_handler(SDL_Event * event);
 static uint32_t keycode_to_ctrl_key(SDL_Keycode sdl_key);
@@ -105,8 +107,6 @@ monitor_t monitor;
 monitor_t monitor2;
 #endif
 
-static volatile bool sdl_quit_qry = false;
-
 static bool left_button_down = false;
 static int16_t last_x = 0;
 static int16_t last_y = 0;
@@ -116,6 +116,9 @@ static lv_indev_state_t wheel_state = LV_INDEV_STATE_RELEASED;
 
 static char buf[KEYBOARD_BUFFER_SIZE];
 
+static sdl_overlay_cb_t overlay_cb;
+static lv_color_t overlay_tint;
+
 /**********************
  *      MACROS
  **********************/
@@ -129,8 +132,6 @@ void sdl_init(void)
     /*Initialize the SDL*/
     SDL_Init(SDL_INIT_VIDEO);
 
-    SDL_SetEventFilter(quit_filter, NULL);
-
     window_create(&monitor);
 #if SDL_DUAL_DISPLAY
     window_create(&monitor2);
@@ -148,7 +149,38 @@ void sdl_init(void)
      * how much time were elapsed Create an SDL thread to do this*/
     SDL_CreateThread(tick_thread, "tick", NULL);
 #endif
-    lv_timer_create(sdl_event_handler, 10, NULL);
+}
+
+/**
+ * Destroy the windows and shut down SDL
+ */
+void sdl_deinit(void)
+{
+    monitor_sdl_clean_up();
+}
+
+/**
+ * Handle the window events collected by the event pump, e.g. redraw exposed windows.
+ * Call it once per main loop iteration after `event_pump_poll()`.
+ */
+void sdl_window_task(void)
+{
+    SDL_Event event;
+    while(event_pump_pop(EVENT_QUEUE_WINDOW, &event)) {
+        switch(event.window.event) {
+#if SDL_VERSION_ATLEAST(2, 0, 5)
+            case SDL_WINDOWEVENT_TAKE_FOCUS:
+#endif
+            case SDL_WINDOWEVENT_EXPOSED:
+                window_update(&monitor);
+#if SDL_DUAL_DISPLAY
+                window_update(&monitor2);
+#endif
+                break;
+            default:
+                break;
+        }
+    }
 }
 
 /**
@@ -173,40 +205,88 @@ void sdl_display_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_colo
 #if SDL_DOUBLE_BUFFERED
     monitor.tft_fb_act = (uint32_t *)color_p;
 #else /*SDL_DOUBLE_BUFFERED*/
+    /*In direct mode `color_p` is the whole screen sized buffer*/
+    lv_coord_t src_stride = lv_area_get_width(area);
+    if(disp_drv->direct_mode) {
+        src_stride = hres;
+        color_p += area->y1 * hres + area->x1;
+    }
+    sdl_display_copy_rows(disp_drv, area, color_p, src_stride, area->y1, area->y2);
+#endif /*SDL_DOUBLE_BUFFERED*/
 
+    monitor.sdl_refr_qry = true;
+
+    /* TYPICALLY YOU DO NOT NEED THIS
+     * If it was the last part to refresh update the texture of the window.*/
+    if(lv_disp_flush_is_last(disp_drv)) {
+        monitor_sdl_refr(NULL);
+    }
+
+    /*IMPORTANT! It must be called to tell the system the flush is ready*/
+    lv_disp_flush_ready(disp_drv);
+
+}
+
+#if SDL_DOUBLE_BUFFERED == 0
+/**
+ * Copy a range of rows of a rendered area to the frame buffer of the window.
+ * Doesn't touch LVGL or SDL so it can run on a thread of its own.
+ * @param disp_drv pointer to driver where this function belongs
+ * @param area the area `color_p` was rendered for
+ * @param color_p the first pixel of `area`
+ * @param src_stride distance between two rows of `color_p` in pixels
+ * @param y1 first row to copy (absolute coordinate)
+ * @param y2 last row to copy (absolute coordinate)
+ */
+void sdl_display_copy_rows(lv_disp_drv_t * disp_drv, const lv_area_t * area, const lv_color_t * color_p,
+                           lv_coord_t src_stride, lv_coord_t y1, lv_coord_t y2)
+{
     int32_t y;
+    color_p += (y1 - area->y1) * src_stride;
 #if LV_COLOR_DEPTH != 24 && LV_COLOR_DEPTH != 32    /*32 is valid but support 24 for backward compatibility too*/
     int32_t x;
-    for(y = area->y1; y <= area->y2 && y < disp_drv->ver_res; y++) {
+    for(y = y1; y <= y2 && y < disp_drv->ver_res; y++) {
+        const lv_color_t * src = color_p;
+        uint32_t * dst = &monitor.tft_fb[y * disp_drv->hor_res];
         for(x = area->x1; x <= area->x2; x++) {
-            monitor.tft_fb[y * disp_drv->hor_res + x] = lv_color_to32(*color_p);
-            color_p++;
+            dst[x] = lv_color_to32(*src);
+            src++;
         }
-
+        color_p += src_stride;
     }
 #else
     uint32_t w = lv_area_get_width(area);
-    for(y = area->y1; y <= area->y2 && y < disp_drv->ver_res; y++) {
+    for(y = y1; y <= y2 && y < disp_drv->ver_res; y++) {
         memcpy(&monitor.tft_fb[y * SDL_HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
-        color_p += w;
+        color_p += src_stride;
     }
 #endif
-#endif /*SDL_DOUBLE_BUFFERED*/
+}
+#endif /*SDL_DOUBLE_BUFFERED == 0*/
 
+/**
+ * Present the frame buffer in the window. Must be called from the thread running LVGL.
+ */
+void sdl_display_refresh(void)
+{
     monitor.sdl_refr_qry = true;
+    monitor_sdl_refr(NULL);
+}
 
-    /* TYPICALLY YOU DO NOT NEED THIS
-     * If it was the last part to refresh update the texture of the window.*/
-    if(lv_disp_flush_is_last(disp_drv)) {
-        monitor_sdl_refr(NULL);
-    }
-
-    /*IMPORTANT! It must be called to tell the system the flush is ready*/
-    lv_disp_flush_ready(disp_drv);
 
+/**
+ * Set a callback providing areas to tint on top of the frame buffer whenever the window is presented.
+ * The tint is not part of the frame buffer, LVGL doesn't see it.
+ * @param cb store at most `max` areas and their tint opacity and return their count, NULL to disable
+ * @param tint color of the tint
+ */
+void sdl_display_set_overlay(sdl_overlay_cb_t cb, lv_color_t tint)
+{
+    overlay_cb = cb;
+    overlay_tint = tint;
+    sdl_display_refresh();
 }
 
-
 #if SDL_DUAL_DISPLAY
 
 /**
@@ -277,6 +357,8 @@ void sdl_mouse_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
 {
     (void) indev_drv;      /*Unused*/
 
+    pointer_drain();
+
     /*Store the collected data*/
     data->point.x = last_x;
     data->point.y = last_y;
@@ -293,6 +375,8 @@ void sdl_mousewheel_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
 {
     (void) indev_drv;      /*Unused*/
 
+    pointer_drain();
+
     data->state = wheel_state;
     data->enc_diff = wheel_diff;
     wheel_diff = 0;
@@ -308,6 +392,12 @@ void sdl_keyboard_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
     (void) indev_drv;      /*Unused*/
 
     static bool dummy_read = false;
+
+    SDL_Event event;
+    while(event_pump_pop(EVENT_QUEUE_KEYBOARD, &event)) {
+        keyboard_handler(&event);
+    }
+
     const size_t len = strlen(buf);
 
     /*Send a release manually*/
@@ -333,42 +423,18 @@ void sdl_keyboard_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
 
 
 /**
- * SDL main thread. All SDL related task have to be handled here!
- * It initializes SDL, handles drawing and the mouse.
+ * Apply the queued pointer events up to the next left button or finger transition,
+ * so every read reports a single sample and no click is lost.
  */
-
-static void sdl_event_handler(lv_timer_t * t)
+static void pointer_drain(void)
 {
-    (void)t;
-
-    /*Refresh handling*/
     SDL_Event event;
-    while(SDL_PollEvent(&event)) {
+    while(event_pump_peek(EVENT_QUEUE_POINTER) != NULL) {
+        bool was_down = left_button_down;
+        event_pump_pop(EVENT_QUEUE_POINTER, &event);
         mouse_handler(&event);
         mousewheel_handler(&event);
-        keyboard_handler(&event);
-
-        if((&event)->type == SDL_WINDOWEVENT) {
-            switch((&event)->window.event) {
-#if SDL_VERSION_ATLEAST(2, 0, 5)
-                case SDL_WINDOWEVENT_TAKE_FOCUS:
-#endif
-                case SDL_WINDOWEVENT_EXPOSED:
-                    window_update(&monitor);
-#if SDL_DUAL_DISPLAY
-                    window_update(&monitor2);
-#endif
-                    break;
-                default:
-                    break;
-            }
-        }
-    }
-
-    /*Run until quit event not arrives*/
-    if(sdl_quit_qry) {
-        monitor_sdl_clean_up();
-        exit(0);
+        if(left_button_down != was_down) break;
     }
 }
 
@@ -395,22 +461,6 @@ static void monitor_sdl_refr(lv_timer_t * t)
 #endif
 }
 
-int quit_filter(void * userdata, SDL_Event * event)
-{
-    (void)userdata;
-
-    if(event->type == SDL_WINDOWEVENT) {
-        if(event->window.event == SDL_WINDOWEVENT_CLOSE) {
-            sdl_quit_qry = true;
-        }
-    }
-    else if(event->type == SDL_QUIT) {
-        sdl_quit_qry = true;
-    }
-
-    return 1;
-}
-
 static void monitor_sdl_clean_up(void)
 {
     SDL_DestroyTexture(monitor.texture);
@@ -474,6 +524,25 @@ static void window_update(monitor_t * m)
 
     /*Update the renderer with the texture containing the rendered image*/
     SDL_RenderCopy(m->renderer, m->texture, NULL, NULL);
+
+    if(overlay_cb && m == &monitor) {
+        lv_area_t areas[OVERLAY_MAX_AREAS];
+        lv_opa_t opas[OVERLAY_MAX_AREAS];
+        uint32_t cnt = overlay_cb(areas, opas, OVERLAY_MAX_AREAS);
+        uint32_t tint = lv_color_to32(overlay_tint);
+
+        SDL_SetRenderDrawBlendMode(m->renderer, SDL_BLENDMODE_BLEND);
+        for(uint32_t i = 0; i < cnt; i++) {
+            SDL_Rect r;
+            r.x = areas[i].x1 * SDL_ZOOM;
+            r.y = areas[i].y1 * SDL_ZOOM;
+            r.w = lv_area_get_width(&areas[i]) * SDL_ZOOM;
+            r.h = lv_area_get_height(&areas[i]) * SDL_ZOOM;
+            SDL_SetRenderDrawColor(m->renderer, (tint >> 16) & 0xff, (tint >> 8) & 0xff, tint & 0xff, opas[i]);
+            SDL_RenderFillRect(m->renderer, &r);
+        }
+    }
+
     SDL_RenderPresent(m->renderer);
 }
 
@@ -530,7 +599,7 @@ static void mousewheel_handler(SDL_Event * event)
             if(event->wheel.y < 0) wheel_diff++;
             if(event->wheel.y > 0) wheel_diff--;
 #else
-            wheel_diff = -event->wheel.y;
+            wheel_diff -= event->wheel.y;
 #endif
             break;
         case SDL_MOUSEBUTTONDOWN:
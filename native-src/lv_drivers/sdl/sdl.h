@@ -36,6 +36,7 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+typedef uint32_t (*sdl_overlay_cb_t)(lv_area_t * areas, lv_opa_t * opas, uint32_t max);
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -46,6 +47,17 @@ extern "C" {
  */
 void sdl_init(void);
 
+/**
+ * Destroy the windows and shut down SDL
+ */
+void sdl_deinit(void);
+
+/**
+ * Handle the window events collected by the event pump, e.g. redraw exposed windows.
+ * Call it once per main loop iteration after `event_pump_poll()`.
+ */
+void sdl_window_task(void);
+
 /**
  * Flush a buffer to the marked area
  * @param disp_drv pointer to driver where this function belongs
@@ -62,6 +74,32 @@ void sdl_display_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_colo
  */
 void sdl_display_flush2(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
 
+/**
+ * Copy a range of rows of a rendered area to the frame buffer of the window.
+ * Doesn't touch LVGL or SDL so it can run on a thread of its own.
+ * @param disp_drv pointer to driver where this function belongs
+ * @param area the area `color_p` was rendered for
+ * @param color_p the first pixel of `area`
+ * @param src_stride distance between two rows of `color_p` in pixels
+ * @param y1 first row to copy (absolute coordinate)
+ * @param y2 last row to copy (absolute coordinate)
+ */
+void sdl_display_copy_rows(lv_disp_drv_t * disp_drv, const lv_area_t * area, const lv_color_t * color_p,
+                           lv_coord_t src_stride, lv_coord_t y1, lv_coord_t y2);
+
+/**
+ * Present the frame buffer in the window. Must be called from the thread running LVGL.
+ */
+void sdl_display_refresh(void);
+
+/**
+ * Set a callback providing areas to tint on top of the frame buffer whenever the window is presented.
+ * The tint is not part of the frame buffer, LVGL doesn't see it.
+ * @param cb store at most `max` areas and their tint opacity and return their count, NULL to disable
+ * @param tint color of the tint
+ */
+void sdl_display_set_overlay(sdl_overlay_cb_t cb, lv_color_t tint);
+
 /**
  * Get the current position and state of the mouse
  * @param indev_drv pointer to the related input device driver
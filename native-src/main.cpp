@@ -8,6 +8,30 @@
 #include <argparse/argparse.hpp>
 #include "serial.h"
 #include "nextion_parser.h"
+#include "disp_buf.h"
+#include "ui_bench.h"
+#include "stripe_render.h"
+#include "blend565.h"
+#include "draw_simd.h"
+#include "refr_stats.h"
+#include "event_pump.h"
+#include "metrics.h"
+#include "mem_pool.h"
+#include "mem_place.h"
+#include "obj_census.h"
+#include "ui_check.h"
+
+/* Buffer strategies compared by --tune-draw-buf */
+static const char * const tune_configs[] = {
+    "10", "10x2", "40", "40x2", "100", "100x2", "200", "200x2",
+    "full", "fullx2", "direct", "directx2",
+};
+
+/* Screens redrawn by --bench-blend */
+static const char * const bench_pages[] = {"home", "plot"};
+#define BENCH_BLEND_FRAMES 100
+
+#define OVERLAY_PERIOD 30   /* ms between window updates while the redraw overlay fades */
 
 #if LV_USE_LOG != 0
 static void lv_log_print_g_cb(const char * buf)
@@ -16,20 +40,26 @@ static void lv_log_print_g_cb(const char * buf)
 }
 #endif
 
-void lv_app_init(void)
+/* Draw buffers are placed like on the ESP32, in the simulated internal RAM whenever they fit */
+static void * draw_buf_alloc(size_t size)
 {
-    static lv_color_t buf1[480 * 10];
-    static lv_color_t buf2[480 * 10];
-    static lv_disp_draw_buf_t draw_buf;
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, 480 * 10);
+    return mem_place_alloc(size, MEM_PLACE_RENDER);
+}
 
+lv_disp_t * lv_app_init(const disp_buf_config_t * buf_cfg)
+{
     static lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.draw_buf = &draw_buf;
     disp_drv.flush_cb = sdl_display_flush;
     disp_drv.hor_res = 480;
     disp_drv.ver_res = 480;
-    lv_disp_drv_register(&disp_drv);
+    draw_simd_attach(&disp_drv);
+    disp_buf_set_allocator(draw_buf_alloc, mem_place_free);
+    if (!disp_buf_init(&disp_drv, buf_cfg)) {
+        fprintf(stderr, "Failed to allocate draw buffers\n");
+        std::exit(1);
+    }
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
 
     // Handle mouse input
     static lv_indev_drv_t indev_drv;
@@ -37,8 +67,96 @@ void lv_app_init(void)
     indev_drv.type = LV_INDEV_TYPE_POINTER;
     indev_drv.read_cb = sdl_mouse_read;
     lv_indev_t *mouse_indev = lv_indev_drv_register(&indev_drv);
+
+    return disp;
 }
 
+/* Replay the standard scenario with every buffer strategy and print a report */
+void tune_draw_buf(lv_disp_t * disp)
+{
+    ui_bench_warmup();
+
+    printf("%-10s %9s %7s %9s %9s %9s %10s\n",
+           "buffer", "RAM [KB]", "frames", "avg [us]", "p95 [us]", "max [us]", "px/frame");
+
+    for (const char * spec : tune_configs) {
+        disp_buf_config_t cfg;
+        disp_buf_parse_config(spec, &cfg);
+        if (!disp_buf_reconfigure(disp, &cfg)) {
+            printf("%-10s allocation failed\n", spec);
+            continue;
+        }
+
+        ui_bench_result_t res;
+        ui_bench_run(disp, &res);
+
+        size_t ram = disp_buf_get_ram_size(&cfg, lv_disp_get_hor_res(disp), lv_disp_get_ver_res(disp));
+        printf("%-10s %9zu %7u %9u %9u %9u %10u\n",
+               spec, ram / 1024, res.frames, res.avg_us, res.p95_us, res.max_us,
+               res.frames ? res.rendered_px / res.frames : 0);
+    }
+}
+
+/* Redraw the home and plot screens with LVGL's blending and every supported kernel */
+void bench_blend(lv_disp_t * disp)
+{
+    ui_bench_warmup();
+
+    printf("%-8s %-6s %9s %9s %9s %8s\n", "blend", "screen", "avg [us]", "p95 [us]", "max [us]", "speedup");
+
+    uint32_t base_us[sizeof(bench_pages) / sizeof(bench_pages[0])] = {0};
+    blend565_impl_t prev = blend565_get_impl();
+
+    // -1 stands for LVGL's built-in blending, the baseline
+    for (int impl = -1; impl < BLEND565_IMPL_COUNT; impl++) {
+        if (impl >= 0 && !blend565_impl_supported((blend565_impl_t)impl)) continue;
+        draw_simd_set_enabled(impl >= 0);
+        if (impl >= 0) blend565_set_impl((blend565_impl_t)impl);
+        const char * name = impl >= 0 ? blend565_impl_name((blend565_impl_t)impl) : "lvgl";
+
+        for (size_t p = 0; p < sizeof(bench_pages) / sizeof(bench_pages[0]); p++) {
+            ui_bench_result_t res;
+            ui_bench_run_screen(disp, bench_pages[p], BENCH_BLEND_FRAMES, &res);
+            if (impl < 0) base_us[p] = res.avg_us;
+            printf("%-8s %-6s %9u %9u %9u %7.2fx\n", name, bench_pages[p], res.avg_us, res.p95_us, res.max_us,
+                   res.avg_us ? (double)base_us[p] / res.avg_us : 0.0);
+        }
+    }
+
+    draw_simd_set_enabled(true);
+    blend565_set_impl(prev);
+}
+
+/* Play the standard scenario once and fail if any object is left with local style properties */
+int style_audit(lv_disp_t * disp)
+{
+    static obj_census_t census;
+
+    ui_bench_warmup();
+    ui_bench_replay(1, nextion_msg_handler_process);
+
+    obj_census_take(disp, &census);
+    obj_census_publish(&census);
+
+    uint32_t props = obj_census_print_local_styles(&census);
+    printf("Style audit: %s (%u local style properties on %u objects)\n",
+           props == 0 ? "OK" : "FAILED", props, census.total);
+    return props == 0 ? 0 : 1;
+}
+
+/* Feed the redrawn areas to the SDL window overlay */
+static uint32_t refr_overlay_cb(lv_area_t * areas, lv_opa_t * opas, uint32_t max)
+{
+    refr_stats_mark_t marks[REFR_STATS_MAX_MARKS];
+    uint32_t cnt = refr_stats_get_marks(marks, LV_MIN(max, REFR_STATS_MAX_MARKS));
+    for (uint32_t i = 0; i < cnt; i++) {
+        areas[i] = marks[i].area;
+        opas[i] = marks[i].opa;
+    }
+    return cnt;
+}
+
+#ifndef PIO_UNIT_TESTING   /* The tests under test/ have their own main() */
 int main(int argc, char* argv[])
 {
     argparse::ArgumentParser program("gaggiuino-lvgl-display");
@@ -52,6 +170,73 @@ int main(int argc, char* argv[])
         .default_value(115200)
         .scan<'i', int>();
 
+    program.add_argument("--draw-buf")
+        .help("Draw buffer strategy: <lines>, full or direct, append x2 for double buffering")
+        .default_value(std::string("10x2"));
+
+    program.add_argument("--async-flush")
+        .help("Flush rendered stripes on a thread of their own while LVGL renders the next one")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--page-idle-timeout")
+        .help("Delete the widgets of pages hidden for this many ms, they are rebuilt on the next visit (0: keep)")
+        .default_value(0)
+        .scan<'i', int>();
+
+    program.add_argument("--smoothing")
+        .help("Time a gauge or readout takes to follow a telemetry change, in % of the sample interval (0: show samples right away)")
+        .default_value(100)
+        .scan<'i', int>();
+
+    program.add_argument("--refr-stats")
+        .help("Write per-frame redraw statistics to this CSV file")
+        .default_value(std::string(""));
+
+    program.add_argument("--refr-overlay")
+        .help("Tint redrawn areas in the window, fading out over time")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--metrics")
+        .help("Print the UI metrics (updates, skipped updates, invalidated pixels, ...) and the LVGL heap usage on exit")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--blend")
+        .help("Blending kernels: auto, scalar, sse4.1, avx2 or lvgl for LVGL's built-in blending")
+        .default_value(std::string("auto"));
+
+    program.add_argument("--blend-selftest")
+        .help("Compare every blending kernel pixel by pixel with the scalar reference and exit")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--bench-blend")
+        .help("Benchmark full screen redraws of the home and plot pages with every blending kernel and exit")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--alloc-check")
+        .help("Replay the standard scenario this many times through the parser and exit non-zero if handling a message allocates from the system or LVGL heap")
+        .default_value(0)
+        .scan<'i', int>();
+
+    program.add_argument("--leak-check")
+        .help("Replay the standard scenario this many times and exit non-zero if the live LVGL objects of any class and page grew")
+        .default_value(0)
+        .scan<'i', int>();
+
+    program.add_argument("--style-audit")
+        .help("Replay the standard scenario once and exit non-zero if any object has local style properties other than position and size")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--tune-draw-buf")
+        .help("Benchmark the standard scenario with several draw buffer strategies and exit")
+        .default_value(false)
+        .implicit_value(true);
+
     try {
         program.parse_args(argc, argv);
     }
@@ -64,6 +249,26 @@ int main(int argc, char* argv[])
     std::string port = program.get<std::string>("--port");
     int baudrate = program.get<int>("--baudrate");
 
+    disp_buf_config_t buf_cfg;
+    if (!disp_buf_parse_config(program.get<std::string>("--draw-buf").c_str(), &buf_cfg)) {
+        std::cerr << "Invalid --draw-buf value" << std::endl;
+        std::exit(1);
+    }
+
+    std::string blend = program.get<std::string>("--blend");
+    if (blend == "lvgl") {
+        draw_simd_set_enabled(false);
+    } else if (blend != "auto" && !blend565_set_impl(blend565_impl_from_name(blend.c_str()))) {
+        std::cerr << "Unknown or unsupported --blend value" << std::endl;
+        std::exit(1);
+    }
+
+    if (program.get<bool>("--blend-selftest")) {
+        uint32_t failures = blend565_selftest();
+        printf("Blend kernels: %s (%u mismatching cases)\n", failures == 0 ? "OK" : "FAILED", failures);
+        return failures == 0 ? 0 : 1;
+    }
+
     if (!port.empty()) {
         printf("Listening on port %s at %d baud\n", port.c_str(), baudrate);
         if (serial_init(port.c_str(), baudrate, nextion_msg_handler_process) != 0) {
@@ -83,23 +288,107 @@ int main(int argc, char* argv[])
     sdl_init();
 
     /* create Widgets on the screen */
-    lv_app_init();
+    lv_disp_t * disp = lv_app_init(&buf_cfg);
+
+    if (program.get<bool>("--async-flush") && stripe_render_init(disp->driver) != 0) {
+        return 1;
+    }
 
     /* Draw demo widgets */
     lv_gaggiuino_ui_init();
+    lv_gaggiuino_set_page_idle_timeout((uint32_t)program.get<int>("--page-idle-timeout"));
+    lv_gaggiuino_set_smoothing((uint16_t)program.get<int>("--smoothing"));
+    obj_census_set_group_cb(lv_gaggiuino_get_page_name);
+
+    std::string refr_stats_path = program.get<std::string>("--refr-stats");
+    bool refr_overlay = program.get<bool>("--refr-overlay");
+    FILE * refr_stats_csv = NULL;
+    if (!refr_stats_path.empty()) {
+        refr_stats_csv = fopen(refr_stats_path.c_str(), "w");
+        if (refr_stats_csv == NULL) {
+            fprintf(stderr, "Failed to open %s\n", refr_stats_path.c_str());
+            return 1;
+        }
+    }
+    if (refr_stats_csv != NULL || refr_overlay) {
+        refr_stats_init(disp, refr_stats_csv);
+        refr_stats_set_name_cb(lv_gaggiuino_get_object_name);
+    }
+    if (refr_overlay) {
+        sdl_display_set_overlay(refr_overlay_cb, lv_palette_main(LV_PALETTE_PINK));
+    }
+
+    if (program.get<bool>("--tune-draw-buf")) {
+        tune_draw_buf(disp);
+        return 0;
+    }
+
+    if (program.get<bool>("--bench-blend")) {
+        bench_blend(disp);
+        return 0;
+    }
+
+    int alloc_check_rounds = program.get<int>("--alloc-check");
+    if (alloc_check_rounds > 0) {
+        return ui_check_allocs((uint32_t)alloc_check_rounds);
+    }
+
+    int leak_check_rounds = program.get<int>("--leak-check");
+    if (leak_check_rounds > 0) {
+        int res = ui_check_leaks(disp, (uint32_t)leak_check_rounds);
+        if (program.get<bool>("--metrics")) metrics_print();
+        return res;
+    }
+
+    if (program.get<bool>("--style-audit")) {
+        int res = style_audit(disp);
+        if (program.get<bool>("--metrics")) metrics_print();
+        return res;
+    }
 
     Uint32 lastTick = SDL_GetTicks();
+    Uint32 lastOverlay = lastTick;
     while(1) {
         Uint32 current = SDL_GetTicks();
         lv_tick_inc(current - lastTick);
         lastTick = current;
 
+        event_pump_poll();  /* Dispatch SDL events to the input, window and quit queues */
+        if (event_pump_quit_requested()) {
+            break;
+        }
+        sdl_window_task();  /* Redraw exposed windows */
+
         lv_timer_handler(); /* LVGL task */
+        stripe_render_poll(); /* Present stripes flushed by the flush thread */
         serial_task();      /* Serial task */
 
+        /* Keep presenting the window so the overlay fades out between frames */
+        if (refr_overlay && current - lastOverlay >= OVERLAY_PERIOD) {
+            sdl_display_refresh();
+            lastOverlay = current;
+        }
+
         SDL_Delay(5);
     }
 
+    if (program.get<bool>("--metrics")) {
+        static obj_census_t census;
+        obj_census_take(disp, &census);
+        obj_census_publish(&census);
+        metrics_print();
+        mem_pool_print();
+        lv_gaggiuino_print_page_heap();
+        mem_place_print();
+    }
+
+    refr_stats_deinit();
+    if (refr_stats_csv != NULL) {
+        fclose(refr_stats_csv);
+    }
+    stripe_render_deinit();
     serial_close();
+    sdl_deinit();
     return 0;
 }
+#endif /*PIO_UNIT_TESTING*/
@@ -13,27 +13,22 @@ static nextion_message_callback_t user_callback = NULL;
 
 void serial_message_callback(const uint8_t* message, uint16_t length) {
     // TODO: Handle the parsed message
-    printf("Received message of length %d\n", length);
+    NEXTION_LOG("Received message of length %d\n", length);
 
     // print ascii message
-    printf("ASCII: ");
+    NEXTION_LOG("ASCII: ");
     for (uint16_t i = 0; i < length; i++) {
         // check if printable
-        if (message[i] >= 32 && message[i] <= 126) {
-            printf("%c", message[i]);
-        } else {
-            printf(".");
-        }
+        NEXTION_LOG("%c", message[i] >= 32 && message[i] <= 126 ? message[i] : '.');
     }
-    printf("\n");
+    NEXTION_LOG("\n");
 
     // print hex message
-    printf("HEX: ");
+    NEXTION_LOG("HEX: ");
     for (uint16_t i = 0; i < length; i++) {
-        printf("%02X ", message[i]);
+        NEXTION_LOG("%02X ", message[i]);
     }
-    printf("\n");
-    printf("\n");
+    NEXTION_LOG("\n\n");
 }
 
 int serial_init(const char* port, int baudrate, nextion_message_callback_t callback) {
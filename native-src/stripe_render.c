@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "stripe_render.h"
+#include "lv_drivers/sdl/sdl.h"
+
+typedef struct {
+    lv_area_t area;
+    const lv_color_t* color_p;
+    lv_coord_t src_stride;
+    bool last;          // Last stripe of the frame, present the window when done
+} stripe_job_t;
+
+static SDL_Thread* flush_thread;
+static SDL_mutex* lock;
+static SDL_cond* job_cond;      // Signalled when a new stripe is queued
+static SDL_cond* done_cond;     // Signalled when a stripe is copied
+
+static lv_disp_drv_t* disp_drv;
+static stripe_job_t job;
+static bool job_queued;         // Queued for the flush thread
+static bool job_active;         // Queued or copied, not yet reported to LVGL
+static bool quit;
+
+static int flush_main(void* data) {
+    (void)data;
+
+    while (1) {
+        SDL_LockMutex(lock);
+        while (!quit && !job_queued) {
+            SDL_CondWait(job_cond, lock);
+        }
+        if (quit) {
+            SDL_UnlockMutex(lock);
+            return 0;
+        }
+        stripe_job_t stripe = job;
+        SDL_UnlockMutex(lock);
+
+        sdl_display_copy_rows(disp_drv, &stripe.area, stripe.color_p, stripe.src_stride,
+                              stripe.area.y1, stripe.area.y2);
+
+        SDL_LockMutex(lock);
+        job_queued = false;
+        SDL_CondSignal(done_cond);
+        SDL_UnlockMutex(lock);
+    }
+}
+
+static void stripe_flush_cb(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p) {
+    lv_coord_t src_stride = lv_area_get_width(area);
+    if (drv->direct_mode) {
+        // The draw buffer is screen sized, point to the first pixel of the area
+        src_stride = drv->hor_res;
+        color_p += area->y1 * drv->hor_res + area->x1;
+    }
+
+    SDL_LockMutex(lock);
+    job.area = *area;
+    job.color_p = color_p;
+    job.src_stride = src_stride;
+    job.last = lv_disp_flush_is_last(drv);
+    job_queued = true;
+    job_active = true;
+    SDL_CondSignal(job_cond);
+    SDL_UnlockMutex(lock);
+
+    // Return right away, LVGL renders the next stripe into the other buffer meanwhile
+}
+
+static void stripe_wait_cb(lv_disp_drv_t* drv) {
+    (void)drv;
+
+    SDL_LockMutex(lock);
+    while (job_queued) {
+        SDL_CondWait(done_cond, lock);
+    }
+    SDL_UnlockMutex(lock);
+
+    stripe_render_poll();
+}
+
+int stripe_render_init(lv_disp_drv_t* drv) {
+    if (drv->draw_buf != NULL && drv->draw_buf->buf2 == NULL) {
+        fprintf(stderr, "Stripe rendering with a single draw buffer can't overlap rendering and flushing\n");
+    }
+
+    lock = SDL_CreateMutex();
+    job_cond = SDL_CreateCond();
+    done_cond = SDL_CreateCond();
+    disp_drv = drv;
+    quit = false;
+
+    flush_thread = SDL_CreateThread(flush_main, "stripe", NULL);
+    if (flush_thread == NULL) {
+        fprintf(stderr, "Failed to create flush thread: %s\n", SDL_GetError());
+        stripe_render_deinit();
+        return -1;
+    }
+
+    drv->flush_cb = stripe_flush_cb;
+    drv->wait_cb = stripe_wait_cb;
+    return 0;
+}
+
+void stripe_render_poll(void) {
+    if (lock == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(lock);
+    bool done = job_active && !job_queued;
+    bool last = job.last;
+    if (done) {
+        job_active = false;
+    }
+    SDL_UnlockMutex(lock);
+
+    if (!done) {
+        return;
+    }
+
+    if (last) {
+        sdl_display_refresh();
+    }
+    lv_disp_flush_ready(disp_drv);
+}
+
+void stripe_render_deinit(void) {
+    if (lock == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(lock);
+    quit = true;
+    SDL_CondBroadcast(job_cond);
+    SDL_UnlockMutex(lock);
+
+    if (flush_thread != NULL) {
+        SDL_WaitThread(flush_thread, NULL);
+        flush_thread = NULL;
+    }
+
+    SDL_DestroyCond(done_cond);
+    SDL_DestroyCond(job_cond);
+    SDL_DestroyMutex(lock);
+    lock = NULL;
+}
@@ -0,0 +1,38 @@
+#ifndef STRIPE_RENDER_H
+#define STRIPE_RENDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * Flush rendered stripes on a thread of their own.
+ * LVGL keeps rendering on the calling thread: while it rasterizes the next stripe into the
+ * second draw buffer, the flush thread converts the previous stripe into the window frame
+ * buffer. Stripes are flushed strictly in order and only the calling thread ever touches
+ * LVGL or SDL.
+ * Replaces `flush_cb` and `wait_cb` of the driver. Use two draw buffers, with a single one
+ * LVGL has to wait for the flush before rendering the next stripe.
+ * @param drv the display driver, before or after registration
+ * @return 0 on success, -1 on error
+ */
+int stripe_render_init(lv_disp_drv_t* drv);
+
+/**
+ * Finish a flush the thread is done with. Call it once per main loop iteration.
+ */
+void stripe_render_poll(void);
+
+/**
+ * Stop and join the flush thread
+ */
+void stripe_render_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STRIPE_RENDER_H
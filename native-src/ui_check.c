@@ -0,0 +1,122 @@
+#include "ui_check.h"
+#include <stdio.h>
+#include "alloc_guard.h"
+#include "draw_simd.h"
+#include "lv_gaggiuino_ui.h"
+#include "mem_pool.h"
+#include "nextion_parser.h"
+#include "obj_census.h"
+#include "ui_bench.h"
+
+#define HEADLESS_HOR_RES 480
+#define HEADLESS_VER_RES 480
+#define HEADLESS_BUF_LINES 40
+
+#define LEAK_CHECK_IDLE_TIMEOUT 500     // ms, shorter than a page visit of the scenario
+#define LEAK_CHECK_SETTLE_MARGIN 2000   // ms on top of the idle timeout, covers the period of the idle check
+
+static uint32_t pool_allocs;    // mem_pool allocations while handling messages
+
+static void headless_flush_cb(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p) {
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+lv_disp_t* ui_check_init_headless(void) {
+    static lv_color_t buf[HEADLESS_HOR_RES * HEADLESS_BUF_LINES];
+    static lv_disp_draw_buf_t draw_buf;
+    static lv_disp_drv_t disp_drv;
+
+    lv_init();
+
+    lv_disp_draw_buf_init(&draw_buf, buf, NULL, HEADLESS_HOR_RES * HEADLESS_BUF_LINES);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.flush_cb = headless_flush_cb;
+    disp_drv.draw_buf = &draw_buf;
+    disp_drv.hor_res = HEADLESS_HOR_RES;
+    disp_drv.ver_res = HEADLESS_VER_RES;
+    draw_simd_attach(&disp_drv);
+    lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
+
+    lv_gaggiuino_ui_init();
+    obj_census_set_group_cb(lv_gaggiuino_get_page_name);
+    return disp;
+}
+
+/* Only the message handling is guarded, rendering the frames between messages isn't part of the protocol loop */
+static void alloc_check_cb(const uint8_t* message, uint16_t length) {
+    mem_pool_stats_t stats;
+    mem_pool_get_stats(&stats);
+    uint32_t allocs = stats.allocs;
+
+    alloc_guard_arm();
+    nextion_msg_handler_process(message, length);
+    alloc_guard_disarm();
+
+    mem_pool_get_stats(&stats);
+    pool_allocs += stats.allocs - allocs;
+}
+
+int ui_check_allocs(uint32_t rounds) {
+    if (!alloc_guard_supported()) {
+        printf("Allocation check: not supported on this platform\n");
+        return 1;
+    }
+
+    ui_bench_warmup();
+    // Pages are built and texts reach their longest length in the first round
+    ui_bench_replay(1, nextion_msg_handler_process);
+
+    alloc_guard_reset();
+    pool_allocs = 0;
+    uint32_t messages = ui_bench_replay(rounds, alloc_check_cb);
+
+    alloc_guard_stats_t stats;
+    alloc_guard_get_stats(&stats);
+    bool ok = stats.allocs == 0 && pool_allocs == 0;
+    printf("Allocation check: %s (%u messages, %u system heap allocations, %u frees, %u LVGL heap allocations)\n",
+           ok ? "OK" : "FAILED", messages, stats.allocs, stats.frees, pool_allocs);
+    if (stats.allocs > 0) {
+        printf("First allocation: %zu bytes from %p\n", stats.first_size, stats.first_caller);
+    }
+    return ok ? 0 : 1;
+}
+
+/* Run the timers until every hidden page is deleted, so each census sees the same pages built */
+static void settle_idle_pages(void) {
+    uint32_t settle = lv_gaggiuino_get_page_idle_timeout() + LEAK_CHECK_SETTLE_MARGIN;
+    for (uint32_t t = 0; t < settle; t += LV_DISP_DEF_REFR_PERIOD) {
+        lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+        lv_timer_handler();
+    }
+}
+
+int ui_check_leaks(lv_disp_t* disp, uint32_t rounds) {
+    static obj_census_t before, after;
+
+    // Pages are never deleted without an idle timeout, the rebuilds wouldn't be checked
+    uint32_t idle_timeout = lv_gaggiuino_get_page_idle_timeout();
+    if (idle_timeout == 0) lv_gaggiuino_set_page_idle_timeout(LEAK_CHECK_IDLE_TIMEOUT);
+
+    ui_bench_warmup();
+    // Every page is built in the first round, the second one brings idle pages into their cycle
+    ui_bench_replay(2, nextion_msg_handler_process);
+    settle_idle_pages();
+
+    obj_census_take(disp, &before);
+    uint32_t builds = lv_gaggiuino_get_page_builds();
+    ui_bench_replay(rounds, nextion_msg_handler_process);
+    uint32_t rebuilt = lv_gaggiuino_get_page_builds() - builds;
+    settle_idle_pages();
+    obj_census_take(disp, &after);
+    obj_census_publish(&after);
+
+    lv_gaggiuino_set_page_idle_timeout(idle_timeout);
+
+    uint32_t gained = obj_census_diff(&before, &after);
+    bool ok = gained == 0 && rebuilt > 0;
+    printf("Leak check: %s (%u objects before, %u after %u rounds, %u pages rebuilt)\n",
+           ok ? "OK" : "FAILED", before.total, after.total, rounds, rebuilt);
+    return ok ? 0 : 1;
+}
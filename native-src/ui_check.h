@@ -0,0 +1,41 @@
+#ifndef UI_CHECK_H
+#define UI_CHECK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * Bring up LVGL and the UI on a display without a window, for the unit tests.
+ * Rendered stripes are dropped, the blending kernels are attached like in the simulator.
+ * @return the display
+ */
+lv_disp_t* ui_check_init_headless(void);
+
+/**
+ * Replay the standard scenario through the parser and check that handling a message
+ * neither called the system allocator nor allocated from the LVGL heap (mem_pool).
+ * One round is played unchecked first, it builds every page and grows the stored texts.
+ * @param rounds number of checked rounds
+ * @return 0 if no message allocated, 1 otherwise or if the system allocator can't be guarded
+ */
+int ui_check_allocs(uint32_t rounds);
+
+/**
+ * Cycle through the pages with the standard scenario and check that no class of objects grew on any page.
+ * Without a page idle timeout set, LEAK_CHECK_IDLE_TIMEOUT is used meanwhile so hidden pages are deleted
+ * and rebuilt. The objects are counted once every hidden page is deleted.
+ * @param disp the display of the UI
+ * @param rounds number of measured rounds
+ * @return 0 if nothing grew and at least one page was rebuilt, 1 otherwise
+ */
+int ui_check_leaks(lv_disp_t* disp, uint32_t rounds);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_CHECK_H*/
@@ -0,0 +1,178 @@
+#
+# Compress indexed images exported by the LVGL image converter for the decoder of img_rle.h.
+#
+# Every row of the index bitmap is PackBits encoded on its own and found through a table of row
+# offsets, so the decoder can unpack any row on demand without a decoded copy of the image.
+#
+# Run by PlatformIO before each build, an image is compressed again when its source changed.
+# From the command line:
+#   python scripts/compress-images.py                   compress all images listed in ASSETS
+#   python scripts/compress-images.py <src.c> <dst.c>   compress one image
+#
+
+import os
+import re
+import sys
+
+# Converter output in assets/ -> compressed C file built with the project
+ASSETS = [
+  ("assets/splash.c", "lib/common/splash.c"),
+]
+
+ROW_OFFSET_MAX = 0xFFFF   # Row offsets are stored in 16 bits
+
+
+def parse_image(path):
+  with open(path, "r") as f:
+    text = f.read()
+
+  text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+  text = re.sub(r"//[^\n]*", "", text)
+
+  m = re.search(r"uint8_t\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};", text, flags=re.S)
+  if m is None:
+    raise ValueError(path + ": no image map found")
+  data = bytes(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", m.group(2)))
+
+  m = re.search(r"lv_img_dsc_t\s+(\w+)\s*=\s*\{(.*?)\};", text, flags=re.S)
+  if m is None:
+    raise ValueError(path + ": no image descriptor found")
+  name, fields = m.group(1), m.group(2)
+
+  cf = re.search(r"\.header\.cf\s*=\s*LV_IMG_CF_INDEXED_(\d)BIT", fields)
+  w = re.search(r"\.header\.w\s*=\s*(\d+)", fields)
+  h = re.search(r"\.header\.h\s*=\s*(\d+)", fields)
+  if cf is None or w is None or h is None:
+    raise ValueError(path + ": only LV_IMG_CF_INDEXED_xBIT images are supported")
+
+  return name, int(cf.group(1)), int(w.group(1)), int(h.group(1)), data
+
+
+def packbits(row):
+  out = bytearray()
+  i = 0
+  while i < len(row):
+    run = 1
+    while i + run < len(row) and run < 128 and row[i + run] == row[i]:
+      run += 1
+    if run >= 2:
+      out += bytes([257 - run, row[i]])
+      i += run
+      continue
+
+    # Literal bytes up to the next run of at least 3, a run of 2 is cheaper kept in the literal
+    start = i
+    while i < len(row) and i - start < 128:
+      if i + 2 < len(row) and row[i] == row[i + 1] == row[i + 2]:
+        break
+      i += 1
+    out += bytes([i - start - 1]) + row[start:i]
+  return bytes(out)
+
+
+def compress(name, bpp, w, h, data):
+  colors = 1 << bpp
+  palette = data[:colors * 4]
+  pixels = data[colors * 4:]
+  stride = (w * bpp + 7) // 8
+
+  if len(pixels) != stride * h:
+    raise ValueError(name + ": expected %d bytes of pixels, found %d" % (stride * h, len(pixels)))
+  if any(palette[i * 4 + 3] != 0xFF for i in range(colors)):
+    raise ValueError(name + ": the palette must be opaque")
+
+  offsets = []
+  stream = bytearray()
+  for y in range(h):
+    offsets.append(len(stream))
+    stream += packbits(pixels[y * stride:(y + 1) * stride])
+  if offsets[-1] > ROW_OFFSET_MAX:
+    raise ValueError(name + ": compressed image too large for 16 bit row offsets")
+
+  out = bytearray([bpp, 0, 0, 0])
+  out += len(stream).to_bytes(4, "little")
+  out += palette
+  for o in offsets:
+    out += o.to_bytes(2, "little")
+  out += stream
+  return bytes(out), len(data)
+
+
+def write_c(path, src, name, w, h, out, raw_size):
+  attr = "LV_ATTRIBUTE_IMG_" + name.upper()
+  lines = []
+  lines.append("/* Generated by scripts/compress-images.py from %s, do not edit */" % src)
+  lines.append("")
+  lines.append("#ifdef __has_include")
+  lines.append("    #if __has_include(\"lvgl.h\")")
+  lines.append("        #ifndef LV_LVGL_H_INCLUDE_SIMPLE")
+  lines.append("            #define LV_LVGL_H_INCLUDE_SIMPLE")
+  lines.append("        #endif")
+  lines.append("    #endif")
+  lines.append("#endif")
+  lines.append("")
+  lines.append("#if defined(LV_LVGL_H_INCLUDE_SIMPLE)")
+  lines.append("    #include \"lvgl.h\"")
+  lines.append("#else")
+  lines.append("    #include \"lvgl/lvgl.h\"")
+  lines.append("#endif")
+  lines.append("#include \"img_rle.h\"")
+  lines.append("")
+  lines.append("#ifndef LV_ATTRIBUTE_MEM_ALIGN")
+  lines.append("#define LV_ATTRIBUTE_MEM_ALIGN")
+  lines.append("#endif")
+  lines.append("")
+  lines.append("#ifndef " + attr)
+  lines.append("#define " + attr)
+  lines.append("#endif")
+  lines.append("")
+  lines.append("/* %d bytes, %d before compression */" % (len(out), raw_size))
+  lines.append("const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST %s uint8_t %s_map[] = {" % (attr, name))
+  for i in range(0, len(out), 20):
+    lines.append("  " + ", ".join("0x%02x" % b for b in out[i:i + 20]) + ",")
+  lines.append("};")
+  lines.append("")
+  lines.append("const lv_img_dsc_t %s = {" % name)
+  lines.append("  .header.cf = IMG_RLE_CF,")
+  lines.append("  .header.always_zero = 0,")
+  lines.append("  .header.reserved = 0,")
+  lines.append("  .header.w = %d," % w)
+  lines.append("  .header.h = %d," % h)
+  lines.append("  .data_size = %d," % len(out))
+  lines.append("  .data = %s_map," % name)
+  lines.append("};")
+
+  with open(path, "w") as f:
+    f.write("\n".join(lines) + "\n")
+
+
+def compress_file(src, dst, label):
+  name, bpp, w, h, data = parse_image(src)
+  out, raw_size = compress(name, bpp, w, h, data)
+  write_c(dst, label, name, w, h, out, raw_size)
+  print("Compressed %s: %d -> %d bytes" % (label, raw_size, len(out)))
+
+
+def compress_assets(project_dir):
+  for src, dst in ASSETS:
+    src_path = os.path.join(project_dir, src)
+    dst_path = os.path.join(project_dir, dst)
+    if os.path.exists(dst_path) and os.path.getmtime(dst_path) >= os.path.getmtime(src_path):
+      continue
+    compress_file(src_path, dst_path, src)
+
+
+try:
+  Import("env")
+except NameError:
+  env = None
+
+if env is not None:
+  compress_assets(env["PROJECT_DIR"])
+elif len(sys.argv) == 3:
+  compress_file(sys.argv[1], sys.argv[2], sys.argv[1])
+elif len(sys.argv) == 1:
+  compress_assets(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+else:
+  print("usage: compress-images.py [<src.c> <dst.c>]")
+  sys.exit(2)
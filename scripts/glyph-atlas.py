@@ -0,0 +1,127 @@
+#
+# Generate the glyph atlas of the numeric readouts (glyph_atlas.h) from LVGL's Montserrat fonts.
+#
+# Only the characters of numbers and units are taken, at the sizes used by readouts, and each
+# glyph is unpacked to one opacity byte per pixel, so drawing it is a single blend of the text
+# color through the glyph as mask.
+#
+# Run by PlatformIO before each build, the atlas is written to the build directory from the fonts
+# of the installed lvgl library. From the command line:
+#   python scripts/glyph-atlas.py <lvgl/src/font> <glyph_atlas_data.h>
+#
+
+import os
+import re
+import sys
+
+ATLAS_SIZES = [20, 28]
+ATLAS_CHARS = "0123456789+-." + "°Cbarml/sg"   # Digits, sign, decimal point and the units
+
+
+def parse_font(path):
+  with open(path, "r", encoding="utf-8") as f:
+    text = f.read()
+
+  fmt = re.search(r"\.bitmap_format\s*=\s*(\d+)", text)
+  if fmt is not None and int(fmt.group(1)) != 0:
+    raise ValueError(path + ": compressed fonts are not supported")
+  bpp = int(re.search(r"\.bpp\s*=\s*(\d+)", text).group(1))
+
+  m = re.search(r"glyph_bitmap\s*\[\s*\]\s*=\s*\{(.*?)\};", text, flags=re.S)
+  if m is None:
+    raise ValueError(path + ": no glyph bitmap found")
+  body = m.group(1)
+  letters = [int(u, 16) for u in re.findall(r"/\*\s*U\+([0-9A-Fa-f]+)", body)]
+  body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)
+  bitmap = bytes(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", body))
+
+  dscs = re.findall(r"\{\s*\.bitmap_index\s*=\s*(\d+),\s*\.adv_w\s*=\s*(\d+),\s*\.box_w\s*=\s*(\d+),"
+                    r"\s*\.box_h\s*=\s*(\d+),\s*\.ofs_x\s*=\s*(-?\d+),\s*\.ofs_y\s*=\s*(-?\d+)\s*\}", text)
+  dscs = [tuple(int(v) for v in d) for d in dscs][1:]   # Glyph id 0 is reserved
+  if len(dscs) != len(letters):
+    raise ValueError(path + ": %d glyph descriptors for %d bitmaps" % (len(dscs), len(letters)))
+
+  return bpp, bitmap, dict(zip(letters, dscs))
+
+
+def unpack_glyph(bpp, bitmap, index, w, h):
+  mask = (1 << bpp) - 1
+  out = bytearray(w * h)
+  for i in range(w * h):
+    bit = i * bpp
+    v = (bitmap[index + (bit >> 3)] >> (8 - bpp - (bit & 7))) & mask
+    out[i] = v * 255 // mask
+  return bytes(out)
+
+
+def build_atlas(font_dir, size):
+  bpp, bitmap, glyphs = parse_font(os.path.join(font_dir, "lv_font_montserrat_%d.c" % size))
+
+  out = bytearray()
+  entries = []
+  for c in sorted(ATLAS_CHARS, key=ord):
+    if ord(c) not in glyphs:
+      raise ValueError("montserrat %d: no glyph for U+%04X" % (size, ord(c)))
+    index, adv_w, box_w, box_h, ofs_x, ofs_y = glyphs[ord(c)]
+    # Rounded like lv_font_get_glyph_width() without kerning
+    entries.append((ord(c), len(out), (adv_w + 8) >> 4, box_w, box_h, ofs_x, ofs_y))
+    out += unpack_glyph(bpp, bitmap, index, box_w, box_h)
+  return bytes(out), entries
+
+
+def write_header(path, font_dir):
+  lines = []
+  lines.append("/* Generated by scripts/glyph-atlas.py from the LVGL Montserrat fonts, do not edit */")
+  lines.append("")
+
+  for size in ATLAS_SIZES:
+    bitmap, entries = build_atlas(font_dir, size)
+    lines.append("#if LV_FONT_MONTSERRAT_%d" % size)
+    lines.append("static const LV_ATTRIBUTE_LARGE_CONST uint8_t atlas_%d_bitmap[] = {" % size)
+    for i in range(0, len(bitmap), 24):
+      lines.append("    " + ", ".join("0x%02x" % b for b in bitmap[i:i + 24]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const glyph_atlas_glyph_t atlas_%d_glyphs[] = {" % size)
+    for e in entries:
+      lines.append("    {.letter = 0x%04x, .offset = %d, .adv_w = %d, .box_w = %d, .box_h = %d, "
+                   ".ofs_x = %d, .ofs_y = %d}," % e)
+    lines.append("};")
+    lines.append("#endif")
+    lines.append("")
+
+  lines.append("static const glyph_atlas_t glyph_atlases[] = {")
+  for size in ATLAS_SIZES:
+    lines.append("#if LV_FONT_MONTSERRAT_%d" % size)
+    lines.append("    {&lv_font_montserrat_%d, atlas_%d_bitmap, atlas_%d_glyphs, %d}," %
+                 (size, size, size, len(ATLAS_CHARS)))
+    lines.append("#endif")
+  lines.append("    {NULL, NULL, NULL, 0}")
+  lines.append("};")
+
+  os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+  with open(path, "w") as f:
+    f.write("\n".join(lines) + "\n")
+  print("Generated glyph atlas %s for sizes %s" % (path, ATLAS_SIZES))
+
+
+try:
+  Import("env")
+except NameError:
+  env = None
+
+if env is not None:
+  font_dir = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"), "lvgl", "src", "font")
+  gen_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+  out = os.path.join(gen_dir, "glyph_atlas_data.h")
+  script = os.path.join(env["PROJECT_DIR"], "scripts", "glyph-atlas.py")
+  if not os.path.isdir(font_dir):
+    print("Glyph atlas: no LVGL fonts in %s, readouts draw with the fonts" % font_dir)
+  elif not os.path.exists(out) or os.path.getmtime(out) < os.path.getmtime(script):
+    write_header(out, font_dir)
+  env.Append(CPPPATH=[gen_dir])
+elif len(sys.argv) == 3:
+  write_header(sys.argv[2], sys.argv[1])
+else:
+  print("usage: glyph-atlas.py <lvgl/src/font> <glyph_atlas_data.h>")
+  sys.exit(2)
@@ -34,6 +34,23 @@ void display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
 
+  /* In direct mode color_p is the screen sized buffer, push the area row by row */
+  if (disp->direct_mode)
+  {
+    color_p += area->y1 * disp->hor_res + area->x1;
+    for (uint32_t y = 0; y < h; y++)
+    {
+#if (LV_COLOR_16_SWAP != 0)
+      gfx->draw16bitBeRGBBitmap(area->x1, area->y1 + y, (uint16_t *)&color_p->full, w, 1);
+#else
+      gfx->draw16bitRGBBitmap(area->x1, area->y1 + y, (uint16_t *)&color_p->full, w, 1);
+#endif
+      color_p += disp->hor_res;
+    }
+    lv_disp_flush_ready(disp);
+    return;
+  }
+
 #if (LV_COLOR_16_SWAP != 0)
   gfx->draw16bitBeRGBBitmap(area->x1, area->y1, (uint16_t *)&color_p->full, w, h);
 #else
@@ -1,21 +1,32 @@
 #ifdef NATIVE
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_main.h>
+#include "../native-src/event_pump.h"
 #else
 #include <Arduino.h>
 #endif
 
 #include "display.hpp"
 #include "lv_demo_widgets.h"
+#include "disp_buf.h"
+#include "mem_place.h"
 
+/* Draw buffer strategy, see disp_buf_parse_config() for the syntax */
+#ifndef DRAW_BUF_CONFIG
+#define DRAW_BUF_CONFIG "200"
+#endif
 
 /* Change to your screen resolution */
 static uint32_t screenWidth;
 static uint32_t screenHeight;
-static lv_disp_draw_buf_t draw_buf;
-static lv_color_t *disp_draw_buf;
 static lv_disp_drv_t disp_drv;
 
+/* Draw buffers are written for every rendered pixel, internal RAM whenever it fits */
+static void *draw_buf_alloc(size_t size)
+{
+  return mem_place_alloc(size, MEM_PLACE_RENDER);
+}
+
 #ifdef USE_SDL
 SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
@@ -66,19 +77,7 @@ void lvgl_init()
   screenHeight = gfx->height();
 #endif
 
-#ifdef ESP32
-  disp_draw_buf = (lv_color_t *)heap_caps_malloc(sizeof(lv_color_t) * screenWidth * 200, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-#else
-  disp_draw_buf = (lv_color_t *)malloc(sizeof(lv_color_t) * screenWidth * 200);
-#endif
-
-  if (!disp_draw_buf)
-  {
-    Serial.println("LVGL disp_draw_buf allocate failed!");
-    return;
-  }
-
-  lv_disp_draw_buf_init(&draw_buf, disp_draw_buf, NULL, screenWidth * 200);
+  disp_buf_set_allocator(draw_buf_alloc, mem_place_free);
 
   /* Initialize the display */
   lv_disp_drv_init(&disp_drv);
@@ -87,7 +86,14 @@ void lvgl_init()
   disp_drv.hor_res = screenWidth;
   disp_drv.ver_res = screenHeight;
   disp_drv.flush_cb = display_flush;
-  disp_drv.draw_buf = &draw_buf;
+
+  disp_buf_config_t buf_cfg;
+  if (!disp_buf_parse_config(DRAW_BUF_CONFIG, &buf_cfg) || !disp_buf_init(&disp_drv, &buf_cfg))
+  {
+    Serial.println("LVGL disp_draw_buf allocate failed!");
+    return;
+  }
+
   lv_disp_drv_register(&disp_drv);
 
   /* Initialize the touchscreen input device driver */
@@ -124,12 +130,10 @@ void setup()
 void loop()
 {
 #ifdef NATIVE
-  SDL_Event event;
-  while (SDL_PollEvent(&event)) {
-    if (event.type == SDL_QUIT) {
-      SDL_Quit();
-      exit(0);
-    }
+  event_pump_poll();
+  if (event_pump_quit_requested()) {
+    SDL_Quit();
+    exit(0);
   }
 #endif
 
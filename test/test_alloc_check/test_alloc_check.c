@@ -0,0 +1,23 @@
+#include <unity.h>
+#include "ui_check.h"
+
+#define ALLOC_CHECK_ROUNDS 2
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/* Handling a message must not allocate from the system heap or from mem_pool */
+static void test_message_handling_does_not_allocate(void) {
+    TEST_ASSERT_EQUAL_INT(0, ui_check_allocs(ALLOC_CHECK_ROUNDS));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    ui_check_init_headless();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_message_handling_does_not_allocate);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "lvgl.h"
+#include "blend565.h"
+#include "ui_check.h"
+
+#define ROW_W 64            // Long enough for the vector loops of every kernel
+#define ROWS_PER_OPA 64
+#define PREMULT_MAX_ERROR 1 // Largest channel difference to LVGL's unmasked fills, see blend565_fill()
+
+static lv_disp_t* disp;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static lv_color_t color_of(uint16_t full) {
+    lv_color_t c;
+    c.full = full;
+    return c;
+}
+
+/* Largest difference of the red, green and blue channels */
+static uint32_t channel_error(uint16_t a, uint16_t b) {
+    lv_color_t ca = color_of(a);
+    lv_color_t cb = color_of(b);
+    uint32_t err = (uint32_t)abs((int)LV_COLOR_GET_R(ca) - (int)LV_COLOR_GET_R(cb));
+    err = LV_MAX(err, (uint32_t)abs((int)LV_COLOR_GET_G(ca) - (int)LV_COLOR_GET_G(cb)));
+    err = LV_MAX(err, (uint32_t)abs((int)LV_COLOR_GET_B(ca) - (int)LV_COLOR_GET_B(cb)));
+    return err;
+}
+
+/* Blend one row with LVGL's own software blending, `src` NULL for a fill of `color` */
+static void lvgl_blend_row(uint16_t* dest, const uint16_t* src, uint16_t color, lv_opa_t opa, const uint8_t* mask) {
+    lv_area_t area = {0, 0, ROW_W - 1, 0};
+    lv_draw_ctx_t draw_ctx;
+    memset(&draw_ctx, 0, sizeof(draw_ctx));
+    draw_ctx.buf = dest;
+    draw_ctx.buf_area = &area;
+    draw_ctx.clip_area = &area;
+
+    lv_draw_sw_blend_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.blend_area = &area;
+    dsc.src_buf = (const lv_color_t*)src;
+    dsc.color = color_of(color);
+    dsc.opa = opa;
+    dsc.mask_buf = (lv_opa_t*)mask;
+    dsc.mask_res = mask ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+    dsc.mask_area = &area;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+    // The blending looks up the display being refreshed for its driver flags
+    _lv_refr_set_disp_refreshing(disp);
+    lv_draw_sw_blend_basic(&draw_ctx, &dsc);
+    _lv_refr_set_disp_refreshing(NULL);
+}
+
+static void random_row(uint16_t* row) {
+    for (int32_t x = 0; x < ROW_W; x++) row[x] = (uint16_t)rand();
+}
+
+/* Every vectorized kernel matches the scalar reference */
+static void test_kernels_match_scalar(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, blend565_selftest());
+}
+
+/* Images, masked or not, and masked fills give the same pixels as LVGL's blending at every opacity */
+static void test_map_and_masked_fill_match_lvgl(void) {
+    uint16_t src[ROW_W], bg[ROW_W], ref[ROW_W], out[ROW_W];
+    uint8_t mask[ROW_W];
+    blend565_impl_t prev = blend565_get_impl();
+    srand(565);
+
+    for (int impl = 0; impl < BLEND565_IMPL_COUNT; impl++) {
+        if (!blend565_set_impl((blend565_impl_t)impl)) continue;
+
+        for (uint32_t opa = 0; opa <= 255; opa++) {
+            for (uint32_t r = 0; r < ROWS_PER_OPA; r++) {
+                random_row(src);
+                random_row(bg);
+                // Every third mask byte at the thresholds of LVGL's mask scaling
+                for (int32_t x = 0; x < ROW_W; x++) {
+                    mask[x] = (x % 3 == 0) ? (uint8_t)(LV_OPA_MAX - 1 + rand() % 4) : (uint8_t)rand();
+                }
+
+                memcpy(ref, bg, sizeof(bg));
+                lvgl_blend_row(ref, src, 0, (lv_opa_t)opa, NULL);
+                memcpy(out, bg, sizeof(bg));
+                blend565_map(out, ROW_W, src, ROW_W, ROW_W, 1, (uint8_t)opa, NULL, ROW_W);
+                TEST_ASSERT_EQUAL_HEX16_ARRAY(ref, out, ROW_W);
+
+                memcpy(ref, bg, sizeof(bg));
+                lvgl_blend_row(ref, src, 0, (lv_opa_t)opa, mask);
+                memcpy(out, bg, sizeof(bg));
+                blend565_map(out, ROW_W, src, ROW_W, ROW_W, 1, (uint8_t)opa, mask, ROW_W);
+                TEST_ASSERT_EQUAL_HEX16_ARRAY(ref, out, ROW_W);
+
+                memcpy(ref, bg, sizeof(bg));
+                lvgl_blend_row(ref, NULL, src[0], (lv_opa_t)opa, mask);
+                memcpy(out, bg, sizeof(bg));
+                blend565_fill(out, ROW_W, ROW_W, 1, src[0], (uint8_t)opa, mask, ROW_W);
+                TEST_ASSERT_EQUAL_HEX16_ARRAY(ref, out, ROW_W);
+            }
+        }
+    }
+    blend565_set_impl(prev);
+}
+
+/* Unmasked fills differ from LVGL's premultiplied mixing by at most PREMULT_MAX_ERROR per channel */
+static void test_fill_error_to_lvgl_fill(void) {
+    uint16_t bg[ROW_W], ref[ROW_W], out[ROW_W];
+    uint32_t max_error = 0;
+    blend565_impl_t prev = blend565_get_impl();
+    srand(565);
+
+    for (int impl = 0; impl < BLEND565_IMPL_COUNT; impl++) {
+        if (!blend565_set_impl((blend565_impl_t)impl)) continue;
+
+        for (uint32_t opa = 0; opa <= 255; opa++) {
+            for (uint32_t r = 0; r < ROWS_PER_OPA; r++) {
+                uint16_t color = (uint16_t)rand();
+                random_row(bg);
+
+                memcpy(ref, bg, sizeof(bg));
+                lvgl_blend_row(ref, NULL, color, (lv_opa_t)opa, NULL);
+                memcpy(out, bg, sizeof(bg));
+                blend565_fill(out, ROW_W, ROW_W, 1, color, (uint8_t)opa, NULL, ROW_W);
+                for (int32_t x = 0; x < ROW_W; x++) {
+                    TEST_ASSERT_EQUAL_HEX16(lv_color_mix(color_of(color), color_of(bg[x]), (uint8_t)opa).full, out[x]);
+                    max_error = LV_MAX(max_error, channel_error(out[x], ref[x]));
+                }
+            }
+        }
+    }
+    blend565_set_impl(prev);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Largest channel error to LVGL's fill: %u", (unsigned)max_error);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(PREMULT_MAX_ERROR, max_error);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    disp = ui_check_init_headless();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_kernels_match_scalar);
+    RUN_TEST(test_map_and_masked_fill_match_lvgl);
+    RUN_TEST(test_fill_error_to_lvgl_fill);
+    return UNITY_END();
+}
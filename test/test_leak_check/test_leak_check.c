@@ -0,0 +1,26 @@
+#include <unity.h>
+#include "lv_gaggiuino_ui.h"
+#include "ui_check.h"
+
+#define LEAK_CHECK_ROUNDS 3
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/* Pages deleted after their idle timeout and built again must not leave objects behind */
+static void test_page_rebuilds_do_not_leak(void) {
+    TEST_ASSERT_EQUAL_INT(0, ui_check_leaks(lv_disp_get_default(), LEAK_CHECK_ROUNDS));
+    // The idle timeout is only set during the check
+    TEST_ASSERT_EQUAL_UINT32(0, lv_gaggiuino_get_page_idle_timeout());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    ui_check_init_headless();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_page_rebuilds_do_not_leak);
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "mem_pool.h"
+
+#define LIVE_MAX 256        // Blocks held at the same time
+#define OPERATIONS 20000
+#define LARGE_MAX 8192      // Largest block, a few of them fill the arena
+
+typedef struct {
+    uint8_t* p;
+    size_t size;
+    uint8_t fill;           // Every byte of the block holds this value
+} live_block_t;
+
+static live_block_t live[LIVE_MAX];
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/* Mostly slab sized blocks, some for the arena's small and large lists */
+static size_t random_size(void) {
+    int r = rand() % 10;
+    if (r < 5) return 1 + rand() % MEM_POOL_SLAB_MAX;
+    if (r < 9) return MEM_POOL_SLAB_MAX + 1 + rand() % 1024;
+    return 1 + rand() % LARGE_MAX;
+}
+
+static int check_contents(const live_block_t* b) {
+    for (size_t i = 0; i < b->size; i++) {
+        if (b->p[i] != b->fill) return 0;
+    }
+    return 1;
+}
+
+/* Random allocations, resizes and frees with every tag, the heap is checked after each one */
+static void test_random_operations_keep_the_heap_consistent(void) {
+    mem_pool_stats_t before, after;
+    mem_pool_get_stats(&before);
+    mem_tag_t prev_tag = mem_pool_set_tag(MEM_TAG_OTHER);
+    srand(41);
+    TEST_ASSERT_EQUAL_UINT32(0, mem_pool_check());
+
+    for (uint32_t op = 0; op < OPERATIONS; op++) {
+        live_block_t* b = &live[rand() % LIVE_MAX];
+        mem_pool_set_tag((mem_tag_t)(rand() % MEM_TAG_COUNT));
+
+        if (b->p == NULL) {
+            size_t size = random_size();
+            b->p = mem_pool_alloc(size);
+            if (b->p != NULL) {
+                b->size = size;
+                b->fill = (uint8_t)rand();
+                memset(b->p, b->fill, size);
+            }
+        } else if (rand() % 2) {
+            size_t size = random_size();
+            uint8_t* p = mem_pool_realloc(b->p, size);
+            if (p != NULL) {
+                // The old contents are kept up to the smaller size
+                b->p = p;
+                if (size < b->size) b->size = size;
+                TEST_ASSERT_TRUE(check_contents(b));
+                b->size = size;
+                memset(b->p, b->fill, size);
+            }
+        } else {
+            TEST_ASSERT_TRUE(check_contents(b));
+            mem_pool_free(b->p);
+            b->p = NULL;
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(0, mem_pool_check());
+    }
+
+    // Blocks that overlapped would have overwritten each other
+    for (int i = 0; i < LIVE_MAX; i++) {
+        if (live[i].p == NULL) continue;
+        TEST_ASSERT_TRUE(check_contents(&live[i]));
+        mem_pool_free(live[i].p);
+        live[i].p = NULL;
+        TEST_ASSERT_EQUAL_UINT32(0, mem_pool_check());
+    }
+    mem_pool_set_tag(prev_tag);
+
+    // Freed blocks are merged back, the heap is left as it was found
+    mem_pool_get_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.used, after.used);
+    TEST_ASSERT_EQUAL_UINT32(before.arena_free, after.arena_free);
+    TEST_ASSERT_EQUAL_UINT32(before.arena_largest, after.arena_largest);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_random_operations_keep_the_heap_consistent);
+    return UNITY_END();
+}
@@ -0,0 +1,42 @@
+#include <unity.h>
+#include "popup_queue.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/* Repeats of a waiting message don't keep its burst open, a later message is queued behind it */
+static void test_duplicates_do_not_extend_a_burst(void) {
+    popup_queue_stats_t stats;
+
+    popup_queue_push("A", 0);
+    TEST_ASSERT_EQUAL_INT(POPUP_QUEUE_SHOW, popup_queue_next(0));
+    TEST_ASSERT_EQUAL_STRING("A", popup_queue_get_text());
+
+    // B waits behind A, the controller keeps re-sending it
+    popup_queue_push("B", 1000);
+    for (uint32_t t = 1000 + POPUP_QUEUE_COALESCE / 2; t < 1000 + 4 * POPUP_QUEUE_COALESCE; t += POPUP_QUEUE_COALESCE / 2) {
+        popup_queue_push("B", t);
+    }
+    popup_queue_push("C", 1000 + 4 * POPUP_QUEUE_COALESCE);
+
+    popup_queue_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(2, popup_queue_get_depth());
+
+    uint32_t now = POPUP_QUEUE_MIN_SHOW + 2000;
+    TEST_ASSERT_EQUAL_INT(POPUP_QUEUE_SHOW, popup_queue_next(now));
+    TEST_ASSERT_EQUAL_STRING("B", popup_queue_get_text());
+    now += POPUP_QUEUE_MIN_SHOW;
+    TEST_ASSERT_EQUAL_INT(POPUP_QUEUE_SHOW, popup_queue_next(now));
+    TEST_ASSERT_EQUAL_STRING("C", popup_queue_get_text());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_duplicates_do_not_extend_a_burst);
+    return UNITY_END();
+}
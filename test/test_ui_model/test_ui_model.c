@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "lvgl.h"
+#include "metrics.h"
+#include "nextion_parser.h"
+#include "popup_queue.h"
+#include "ui_bench.h"
+#include "ui_check.h"
+#include "ui_model.h"
+
+#define UNKNOWN_KEYS (UI_MODEL_MAX_ENTRIES + 8)
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void send(const char* message) {
+    nextion_msg_handler_process((const uint8_t*)message, (uint16_t)strlen(message));
+}
+
+static void run_frames(uint32_t frames) {
+    for (uint32_t f = 0; f < frames; f++) {
+        lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+        lv_timer_handler();
+    }
+}
+
+/* Names no widget shows don't take the model slots of the ones that are shown */
+static void test_popup_after_many_unknown_keys(void) {
+    char message[48];
+    uint32_t unbound = *metrics_get("model.unbound");
+
+    for (uint32_t i = 0; i < UNKNOWN_KEYS; i++) {
+        snprintf(message, sizeof(message), "page%u.t%u.txt=\"unused\"", (unsigned)i, (unsigned)i);
+        send(message);
+        snprintf(message, sizeof(message), "var%u=%u", (unsigned)i, (unsigned)i);
+        send(message);
+    }
+    send("currentTemp=93");
+    send("popupMSG.t0.txt=\"Descaling finished\"");
+    send("page popupMSG");
+    run_frames(5);
+
+    TEST_ASSERT_EQUAL_UINT32(2 * UNKNOWN_KEYS, *metrics_get("model.unbound") - unbound);
+    TEST_ASSERT_EQUAL_UINT32(0, *metrics_get("model.failed"));
+    TEST_ASSERT_NULL(ui_model_get_text("page0.t0"));
+
+    int32_t temp;
+    TEST_ASSERT_TRUE(ui_model_get_value("currentTemp", &temp));
+    TEST_ASSERT_EQUAL_INT32(93, temp);
+    TEST_ASSERT_EQUAL_STRING("Descaling finished", popup_queue_get_text());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    ui_check_init_headless();
+    ui_bench_warmup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_popup_after_many_unknown_keys);
+    return UNITY_END();
+}